@@ -0,0 +1,115 @@
+/**
+ * @file UtilitiesBench.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains micro-benchmarks comparing the string utilities with their previous implementations.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <string>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "util/Utilities.hpp"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::regex;
+using std::string;
+using std::vector;
+
+namespace utils = abuseipdb_client::utils;
+
+namespace baseline {
+
+    /**
+     * @brief The previous regexMatch, which compiled the pattern on every call.
+     */
+    bool regexMatch(const string& haystack, const string& pattern) {
+        const regex regPattern(pattern);
+        return std::regex_match(haystack, regPattern);
+    }
+
+    /**
+     * @brief The previous replaceString, which replaced each occurrence separately.
+     *
+     * The search continues after each replacement, so the result matches replaceInPlace.
+     */
+    string replaceString(string& haystack, const string& needle, const string& replacement) {
+        size_t needleLocation = 0;
+
+        while ((needleLocation = haystack.find(needle, needleLocation)) != string::npos) {
+            haystack.replace(needleLocation, needle.size(), replacement);
+            needleLocation += replacement.size();
+        }
+
+        return haystack;
+    }
+
+}
+
+static volatile size_t g_sink = 0; //!< Keeps the compiler from discarding the benchmarked calls
+
+/**
+ * @brief Runs a function a number of times and prints the average time per iteration.
+ *
+ * @param name The name of the benchmark.
+ * @param iterations The no. of iterations.
+ * @param func The function to benchmark. Its return value is consumed.
+ */
+template<typename Func>
+void runBenchmark(const char* name, const size_t iterations, Func&& func) {
+    g_sink = g_sink + func(); // warm up caches
+
+    const auto start = steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) { g_sink = g_sink + func(); }
+    const auto elapsed = duration<double, std::nano>(steady_clock::now() - start);
+
+    std::printf("%-40s %12.1f ns/iter\n", name, elapsed.count() / iterations);
+}
+
+int main(int32_t argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+    // regexMatch: the config path pattern used by ConfigManager
+    const string configPattern = R"(([A-z0-9_-]+\.?)+)";
+    const string configPath = "Reporting.AggregationWindowSeconds";
+
+    runBenchmark("regexMatch (uncached)", iterations, [&]() { return static_cast<size_t>(baseline::regexMatch(configPath, configPattern)); });
+    runBenchmark("regexMatch (cached)", iterations, [&]() { return static_cast<size_t>(utils::regexMatch(configPath, configPattern)); });
+
+    // splitString vs. splitView: a line of a plaintext blacklist with comment
+    const string line = "193.41.200.1, 193.41.200.2; 10.0.0.0/8 # comment with some words in it";
+    const string delimiters = " ,;#/";
+
+    runBenchmark("splitString", iterations, [&]() { return utils::splitString(line, delimiters).size(); });
+    runBenchmark("splitView", iterations, [&]() {
+        size_t count = 0;
+        for (const auto token : utils::splitView(line, delimiters)) { count += token.size(); }
+        return count;
+    });
+
+    // replaceString vs. replaceInPlace: escaping a report comment, shrinking and growing
+    string comment{};
+    for (size_t i = 0; i < 64; i++) { comment += "Failed password for root from 193.41.200.1 port 22\n"; }
+
+    runBenchmark("replaceString baseline (grow)", iterations, [&]() { auto copy = comment; return baseline::replaceString(copy, "\n", "\\n").size(); });
+    runBenchmark("replaceInPlace (grow)", iterations, [&]() { auto copy = comment; utils::replaceInPlace(copy, "\n", "\\n"); return copy.size(); });
+    runBenchmark("replaceString baseline (shrink)", iterations, [&]() { auto copy = comment; return baseline::replaceString(copy, "root", "r").size(); });
+    runBenchmark("replaceInPlace (shrink)", iterations, [&]() { auto copy = comment; utils::replaceInPlace(copy, "root", "r"); return copy.size(); });
+
+    return 0;
+}
@@ -2,8 +2,62 @@
 ##  Simple CMake script that reads the default      ##
 ##  configuration into a CMake variable, so it may  ##
 ##  be used in configure_files.                     ##
+##  Comments are stripped and the config is         ##
+##  validated here, so the application never has    ##
+##  to parse its defaults at runtime.               ##
 ##                  © Simon Cahill                  ##
 ######################################################
 
 set(abuseipdb_CONFIG_FILE "${CMAKE_CURRENT_SOURCE_DIR}/cfg/config.json")
-file(READ "${abuseipdb_CONFIG_FILE}" abuseipdb_DEFAULT_CONFIG)
\ No newline at end of file
+set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${abuseipdb_CONFIG_FILE}")
+
+file(READ "${abuseipdb_CONFIG_FILE}" abuseipdb_DEFAULT_CONFIG)
+
+# strip full-line comments and the blank lines they leave behind
+string(REGEX REPLACE "(^|\n)[ \t]*//[^\n]*" "" abuseipdb_DEFAULT_CONFIG "${abuseipdb_DEFAULT_CONFIG}")
+string(REGEX REPLACE "\n[ \t]*\n" "\n" abuseipdb_DEFAULT_CONFIG "${abuseipdb_DEFAULT_CONFIG}")
+string(STRIP "${abuseipdb_DEFAULT_CONFIG}" abuseipdb_DEFAULT_CONFIG)
+
+string(JSON abuseipdb_DEFAULT_CONFIG_TYPE ERROR_VARIABLE abuseipdb_DEFAULT_CONFIG_ERROR TYPE "${abuseipdb_DEFAULT_CONFIG}")
+if (abuseipdb_DEFAULT_CONFIG_ERROR OR NOT abuseipdb_DEFAULT_CONFIG_TYPE STREQUAL "OBJECT")
+    message(FATAL_ERROR "${abuseipdb_CONFIG_FILE} is not a valid JSON object: ${abuseipdb_DEFAULT_CONFIG_ERROR}")
+endif()
+
+######################################################
+##  Reads a single default value and checks its     ##
+##  type, so it can be embedded as a typed constant.##
+##  Booleans are converted to true/false.           ##
+######################################################
+function(abuseipdb_get_default_config OUTPUT_VAR EXPECTED_TYPE)
+    string(JSON valueType ERROR_VARIABLE error TYPE "${abuseipdb_DEFAULT_CONFIG}" ${ARGN})
+    if (error)
+        message(FATAL_ERROR "${abuseipdb_CONFIG_FILE}: ${error}")
+    elseif (NOT valueType STREQUAL EXPECTED_TYPE)
+        string(JOIN "." path ${ARGN})
+        message(FATAL_ERROR "${abuseipdb_CONFIG_FILE}: ${path} must be of type ${EXPECTED_TYPE}, but is ${valueType}")
+    endif()
+
+    string(JSON value GET "${abuseipdb_DEFAULT_CONFIG}" ${ARGN})
+    if (EXPECTED_TYPE STREQUAL "BOOLEAN")
+        if (value)
+            set(value "true")
+        else()
+            set(value "false")
+        endif()
+    endif()
+
+    set(${OUTPUT_VAR} "${value}" PARENT_SCOPE)
+endfunction()
+
+abuseipdb_get_default_config(abuseipdb_DEFAULT_RUN_AS_DAEMON            BOOLEAN RunAsDaemon)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_WAKEUP_TIME_SECONDS      NUMBER  WakeupTimeSeconds)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_API_KEY                  STRING  AbuseIpDb ApiKey)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_AGGREGATION_WINDOW       NUMBER  Reporting AggregationWindowSeconds)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_FAIL2BAN_ENABLED         BOOLEAN Fail2Ban Enabled)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_FAIL2BAN_DB_FILE         STRING  Fail2Ban DbFile)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_ENDLESSH_ENABLED         BOOLEAN Endlessh Enabled)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_USE_ENDLESSH_REPORT      BOOLEAN Endlessh UseEndlesshReport)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_MQTT_BROKER_ADDRESS      STRING  Mqtt BrokerAddress)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_MQTT_BROKER_PORT         NUMBER  Mqtt BrokerPort)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_MQTT_USERNAME            STRING  Mqtt Username)
+abuseipdb_get_default_config(abuseipdb_DEFAULT_MQTT_PASSWORD            STRING  Mqtt Password)
@@ -15,9 +15,13 @@
 //  SYSTEM INCLUDES  //
 ///////////////////////
 // stl
+#include <atomic>
+#include <ctime>
 #include <exception>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 // spdlog / fmt
@@ -33,6 +37,14 @@
 ///////////////////////
 //  LOCAL  INCLUDES  //
 ///////////////////////
+#include "api/CheckResult.hpp"
+#include "api/RateLimiter.hpp"
+#include "api/RequestTiming.hpp"
+#include "api/ReportSuppressor.hpp"
+#include "api/SubnetReport.hpp"
+#include "blacklist/BlackList.hpp"
+#include "blacklist/BlackListHolder.hpp"
+#include "metrics/MetricsRegistry.hpp"
 
 namespace abuseipdb_client { namespace api {
 
@@ -41,7 +53,10 @@ namespace abuseipdb_client { namespace api {
     using spdlog::formatter;
     using spdlog::logger;
 
+    using std::atomic;
     using std::make_shared;
+    using std::map;
+    using std::pair;
     using std::shared_ptr;
     using std::string;
     using std::vector;
@@ -61,42 +76,131 @@ namespace abuseipdb_client { namespace api {
             enum class ReportCategories: uint64_t; //!< Enumeration of possible report categories
 
             struct BlackListOptions; //!< Contains the options for requesting a blacklist
+            struct BulkReportEntry; //!< A single line of a bulk report
+            struct BulkReportResult; //!< The parsed response of a bulk report
 
         public: // +++ Constants +++
             const static size_t MAX_IPS_STANDARD; //!< 10.000
             const static size_t MAX_IPS_BASIC_SUB; //!< 100.000
             const static size_t MAX_IPS_PREMIUM_SUB; //!< 500.000
 
+            const static size_t MAX_SUBNET_STANDARD; //!< /24
+            const static size_t MAX_SUBNET_BASIC_SUB; //!< /20
+            const static size_t MAX_SUBNET_PREMIUM_SUB; //!< /16
+
+            const static size_t MAX_AGE_IN_DAYS; //!< 365
+
+            const static size_t MAX_BULK_REPORT_LINES; //!< 10.000
+            const static size_t MAX_BULK_REPORT_SIZE; //!< 2MiB
+
+            const static size_t MAX_CHECK_BLOCKED_REQUESTS; //!< 4096 sub-prefixes per checkBlocked() fan-out
+
         public: // +++ Constructor / Destructor +++
             AbuseIpDbApi(const AbuseIpDbApi&) = delete;
             virtual ~AbuseIpDbApi() { curl_easy_cleanup(m_curl); }
 
         public: // +++ API Endpoints +++
             virtual json    bulkReport(const string& csv)                                      ; //!< Upload a CSV for bulk-reporting
+            virtual BulkReportResult bulkReport(const vector<BulkReportEntry>&, const size_t = 1) ; //!< Bulk-reports a list of reports, resubmitting retryable rows
+            virtual vector<BulkReportResult> bulkReportChunked(const vector<BulkReportEntry>&, const size_t = 4, const size_t = 1); //!< Splits a large list of reports into compliant chunks and uploads them concurrently
             virtual json    checkBlocked(const string&, const size_t)                          ; //!< Check whether a subnet has reported addresses
-            virtual json    checkIpAddress(const string& ipAddress)                            ; //!< Checks if a single IP has been reported before
+            virtual bool    checkBlocked(const string&, const size_t, SubnetReport&, const size_t = 4, const size_t = MAX_SUBNET_STANDARD); //!< Checks a subnet of any size by fanning out to permissible sub-prefixes
+            virtual json    checkIpAddress(const string& ipAddress, const size_t = 30, const bool = false); //!< Checks if a single IP has been reported before
+            virtual bool    checkIpAddress(const string& ipAddress, CheckResult& result, const size_t = 30, CheckReportCallback = nullptr); //!< Checks if a single IP has been reported before, without building a DOM
             virtual json    clearIpAddress(const string& ipAddress) 	                       ; //!< Clears all reports of a given IP from the user account
             virtual json    getBlackList(const BlackListOptions&)                              ; //!< Gets a (more or less) complete blacklist
+            virtual bool    getBlackList(const BlackListOptions&, shared_ptr<const blacklist::BlackList>&); //!< Gets a blacklist, reusing the cached snapshot if it hasn't changed
             virtual json    reportIp(const string&, const ReportCategories, const string& = ""); //!< Reports a single IP
 
             virtual string  getBlackListPlaintext(const BlackListOptions&)                     ; //!< Gets a (more or less) complete blacklist in plain text
 
+        public: // +++ Getter / Setter +++
+            shared_ptr<metrics::MetricsRegistry> getMetrics() const { return m_metrics; }
+            shared_ptr<RateLimiter>         getRateLimiter() const { return m_rateLimiter; }
+            RequestTraceCallback            getRequestTraceCallback() const { return m_requestTraceCallback; }
+            shared_ptr<ReportSuppressor>    getReportSuppressor() const { return m_reportSuppressor; }
+
+            size_t          getBlackListHitCount() const { return m_blackListHitCount; } //!< Checks answered by the local blacklist
+            size_t          getBlackListMissCount() const { return m_blackListMissCount; } //!< Checks which had to be sent despite a local blacklist
+
+            void            setMetrics(shared_ptr<metrics::MetricsRegistry> val) { m_metrics = val; m_endpointMetrics.clear(); } //!< Records request counts, latencies and the remaining quota. nullptr disables recording.
+            void            setRateLimiter(shared_ptr<RateLimiter> val) { m_rateLimiter = val; } //!< Limits the rate of bulk and concurrent requests. nullptr disables the limit.
+            void            setRequestTraceCallback(RequestTraceCallback val) { m_requestTraceCallback = val; } //!< Receives the timing breakdown of every request. nullptr disables the callback.
+            void            setReportSuppressor(shared_ptr<ReportSuppressor> val) { m_reportSuppressor = val; } //!< Suppresses duplicate reports locally. nullptr disables suppression.
+            void            setLocalBlackList(shared_ptr<const blacklist::BlackListHolder> val, const uint8_t minConfidence = 100) { m_localBlackList = val; m_localBlackListMinConfidence = minConfidence; } //!< Answers checks of listed IPs locally. nullptr disables the lookup.
+
         protected: // +++ Constructor +++
             AbuseIpDbApi(const string& apiKey, shared_ptr<logger> logger):
-            m_apiKey(apiKey), m_curl(nullptr), m_isInitialised(false),
-            m_logger(logger) {
+            m_blackListHitCount(0), m_blackListMissCount(0), m_isInitialised(false), m_curl(nullptr), m_localBlackListMinConfidence(100),
+            m_logger(logger), m_metrics(nullptr), m_rateLimiter(nullptr), m_reportSuppressor(nullptr), m_localBlackList(nullptr),
+            m_requestTraceCallback(nullptr), m_apiKey(apiKey) {
                 initialiseCurl();
             }
 
         protected: // +++ Initialisation +++
             virtual void    initialiseCurl();
 
+        protected: // +++ Request Handling +++
+            virtual json    postBulkReport(curl_mime* form);
+
+            virtual void    recordRequest(const string& endpoint, CURL* handle, const CURLcode result, const string& responseHeaders);
+
+        private: // +++ Types +++
+            /**
+             * @brief The last blacklist downloaded for a set of options.
+             * The validators are sent with the next request, so AbuseIPDB can answer with 304 Not Modified if the list hasn't changed.
+             */
+            struct CachedBlackList {
+                time_t      generatedAt;    //!< meta.generatedAt of the cached list
+
+                shared_ptr<const blacklist::BlackList> list; //!< The cached snapshot (getBlackList)
+
+                string      eTag;           //!< The ETag header of the last response
+                string      lastModified;   //!< The Last-Modified header of the last response
+                string      plaintext;      //!< The cached plain-text list (getBlackListPlaintext)
+
+                CachedBlackList(): generatedAt(0), list(nullptr), eTag(), lastModified(), plaintext() {}
+            };
+
+            /**
+             * @brief The series recordRequest() writes to for a single endpoint, resolved once.
+             * The pointers are owned by m_metrics, which never removes a series.
+             */
+            struct EndpointMetrics {
+                metrics::Histogram*     phaseDurations[5];  //!< dns, connect, tls, server, transfer
+                metrics::Counter*       connections[2];     //!< new, reused
+                metrics::Counter*       requestBytes;
+                metrics::Counter*       responseBytes;
+                metrics::Gauge*         rateLimitLimit;     //!< nullptr until a response contained the header
+                metrics::Gauge*         rateLimitRemaining; //!< nullptr until a response contained the header
+
+                map<long, metrics::Histogram*> durations;   //!< Keyed by HTTP status
+                map<pair<CURLcode, long>, metrics::Counter*> requests; //!< Keyed by curl result and HTTP status
+            };
+
+        private: // +++ Metrics +++
+            EndpointMetrics& getEndpointMetrics(const string& endpoint);
+
         private:
+            atomic<size_t>              m_blackListHitCount;
+            atomic<size_t>              m_blackListMissCount;
+
             bool                        m_isInitialised;
 
             CURL*                       m_curl;
 
+            uint8_t                     m_localBlackListMinConfidence;
+
             shared_ptr<logger>  m_logger;
+            shared_ptr<metrics::MetricsRegistry> m_metrics;
+            shared_ptr<RateLimiter>     m_rateLimiter;
+            shared_ptr<ReportSuppressor> m_reportSuppressor;
+            shared_ptr<const blacklist::BlackListHolder> m_localBlackList;
+
+            map<string, CachedBlackList> m_blackListCache; //!< Keyed by request URL
+            map<string, EndpointMetrics> m_endpointMetrics; //!< Keyed by endpoint; cleared when the registry is replaced
+
+            RequestTraceCallback        m_requestTraceCallback;
 
             string                      m_apiKey;
             string                      m_curlResponse;
@@ -108,7 +212,7 @@ namespace abuseipdb_client { namespace api {
      */
     class AbuseIpDbApi::Factory {
         public: // +++ Constructor / Destructor +++
-            explicit    Factory(const string& apiKey, shared_ptr<logger> logger): m_apiKey(apiKey), m_logger(logger), m_instance(nullptr) {}
+            explicit    Factory(const string& apiKey, shared_ptr<logger> logger): m_instance(nullptr), m_logger(logger), m_apiKey(apiKey) {}
                         Factory(const Factory&) = delete;
             ~           Factory() {}
 
@@ -190,6 +294,44 @@ namespace abuseipdb_client { namespace api {
             minimumConfidence(100), onlyCountries({}), exceptCountries({}) {}
     };
 
+    /**
+     * @brief A single report as it is uploaded in a bulk report.
+     */
+    struct AbuseIpDbApi::BulkReportEntry {
+        string              ipAddress;  //!< The IP address to report
+        ReportCategories    categories; //!< The categories to apply to the report
+        time_t              timestamp;  //!< The time of the attack; 0 will use the current time
+        string              comment;    //!< The comment for the report
+
+        BulkReportEntry(const string& ip, const ReportCategories cats, const string& cmt = "", const time_t time = 0):
+            ipAddress(ip), categories(cats), timestamp(time), comment(cmt) {}
+    };
+
+    /**
+     * @brief The parsed response of a bulk report.
+     * Rejected rows are mapped back to the index of the report which was passed to bulkReport.
+     */
+    struct AbuseIpDbApi::BulkReportResult {
+        /**
+         * @brief A single row rejected by AbuseIPDB.
+         */
+        struct InvalidReport {
+            string  error;          //!< The error message returned by AbuseIPDB
+            string  input;          //!< The input which was rejected (usually the IP address)
+            size_t  rowNumber;      //!< The row number as reported by AbuseIPDB (of the last attempt)
+            size_t  reportIndex;    //!< The index of the report in the original list; SIZE_MAX if it couldn't be mapped
+            bool    retryable;      //!< Whether the error was deemed transient
+        };
+
+        bool                    success;        //!< Whether at least one request was answered by AbuseIPDB
+        size_t                  attempts;       //!< The amount of requests sent
+        size_t                  savedReports;   //!< The total amount of saved reports over all attempts
+        vector<InvalidReport>   invalidReports; //!< All rows which were not saved in the end
+        json                    errors;         //!< Any top-level errors returned by AbuseIPDB
+
+        BulkReportResult(): success(false), attempts(0), savedReports(0), invalidReports({}), errors() {}
+    };
+
     vector<int> getReportCategories(const AbuseIpDbApi::ReportCategories categories);
 
 } /* namespace api */ } /* abuseipdb_client */
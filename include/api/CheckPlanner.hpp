@@ -0,0 +1,72 @@
+/**
+ * @file CheckPlanner.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the declaration of the planner used for checking many addresses at once.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_CHECKPLANNER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_CHECKPLANNER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/AbuseIpDbApi.hpp"
+#include "api/CheckResult.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using std::shared_ptr;
+    using std::string;
+    using std::unordered_map;
+    using std::vector;
+
+    /**
+     * @brief Plans and performs the checks of many IP addresses at once.
+     * 
+     * Pending IPv4 lookups are grouped by their prefix; if a prefix has enough members, a single
+     * checkBlocked request is issued for the whole prefix and the individual lookups are answered from its
+     * list of reported addresses. All other addresses are checked one by one.
+     */
+    class CheckPlanner {
+        public: // +++ Constants +++
+            const static size_t DEFAULT_CLUSTER_THRESHOLD; //!< 4
+            const static size_t DEFAULT_PREFIX_LENGTH; //!< 24
+
+        public: // +++ Constructor / Destructor +++
+            CheckPlanner(shared_ptr<AbuseIpDbApi> api, const size_t clusterThreshold = DEFAULT_CLUSTER_THRESHOLD, const size_t prefixLength = DEFAULT_PREFIX_LENGTH):
+                m_api(api), m_clusterThreshold(clusterThreshold), m_prefixLength(prefixLength), m_requestCount(0), m_savedRequestCount(0) {}
+            CheckPlanner(const CheckPlanner&) = delete;
+            virtual ~CheckPlanner() {}
+
+        public: // +++ Checks +++
+            virtual unordered_map<string, CheckResult> checkIpAddresses(const vector<string>& ipAddresses); //!< Checks all addresses, using as few requests as possible
+
+        public: // +++ Getter +++
+            size_t  getRequestCount() const { return m_requestCount; } //!< The amount of requests sent
+            size_t  getSavedRequestCount() const { return m_savedRequestCount; } //!< The amount of requests saved by checking whole prefixes
+
+        private: // +++ Member Variables +++
+            shared_ptr<AbuseIpDbApi>    m_api;
+
+            size_t                      m_clusterThreshold;
+            size_t                      m_prefixLength;
+            size_t                      m_requestCount;
+            size_t                      m_savedRequestCount;
+    };
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_CHECKPLANNER_HPP
@@ -0,0 +1,95 @@
+/**
+ * @file CheckResult.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a compact, typed representation of the response of the check endpoint.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_CHECKRESULT_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_CHECKRESULT_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace abuseipdb_client { namespace api {
+
+    using std::function;
+    using std::string;
+    using std::string_view;
+
+    /**
+     * @brief The result of checking a single IP address.
+     * 
+     * This struct has a fixed layout and is trivially copyable, so results are cheap to cache.
+     * Use parseCheckResult to fill it directly from the response, without building a JSON DOM.
+     */
+    struct CheckResult {
+        /**
+         * @brief The usage types known to AbuseIPDB.
+         */
+        enum class UsageType: uint8_t {
+            Unknown,
+            Commercial,
+            Organization,
+            Government,
+            Military,
+            UniversityCollegeSchool,
+            Library,
+            ContentDeliveryNetwork,
+            FixedLineIsp,
+            MobileIsp,
+            DataCenterWebHostingTransit,
+            SearchEngineSpider,
+            Reserved
+        };
+
+        time_t      lastReportedAt;         //!< UNIX timestamp of the last report; 0 if never reported
+        uint32_t    totalReports;           //!< The amount of reports within the requested period
+        uint32_t    numDistinctUsers;       //!< The amount of distinct users who reported the IP
+        uint8_t     abuseConfidenceScore;   //!< 0-100
+        uint8_t     ipVersion;              //!< 4 or 6
+        char        countryCode[2];         //!< ISO 3166-1 alpha-2 code; zeroed if unknown
+        UsageType   usageType;              //!< The usage type of the IP
+        bool        isPublic;               //!< Whether the IP is a public address
+        bool        isWhitelisted;          //!< Whether the IP is whitelisted by AbuseIPDB
+        bool        isValid;                //!< Whether the response contained data
+
+        CheckResult():
+            lastReportedAt(0), totalReports(0), numDistinctUsers(0), abuseConfidenceScore(0), ipVersion(0),
+            countryCode{ 0, 0 }, usageType(UsageType::Unknown), isPublic(false), isWhitelisted(false), isValid(false) {}
+
+        string_view getCountryCode() const { return string_view(countryCode, countryCode[1] ? 2 : 0); }
+    };
+
+    /**
+     * @brief A single report of an IP, as contained in a verbose check response.
+     */
+    struct CheckReport {
+        time_t      reportedAt;             //!< UNIX timestamp of the report
+        uint64_t    categories;             //!< The categories, bit-coded like AbuseIpDbApi::ReportCategories
+        uint32_t    reporterId;             //!< The ID of the reporting user
+        char        reporterCountryCode[2]; //!< The country code of the reporting user
+        string      comment;                //!< The comment of the report
+
+        CheckReport(): reportedAt(0), categories(0), reporterId(0), reporterCountryCode{ 0, 0 }, comment() {}
+    };
+
+    using CheckReportCallback = function<void(const CheckReport&)>; //!< Invoked once per report; the report is only valid for the duration of the call
+
+    CheckResult::UsageType  getUsageType(const string_view usageType); //!< Converts AbuseIPDB's usage type string to the enum
+
+    bool                    parseCheckResult(const string& response, CheckResult& result, CheckReportCallback onReport = nullptr); //!< Parses the response of the check endpoint
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_CHECKRESULT_HPP
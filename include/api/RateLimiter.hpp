@@ -0,0 +1,59 @@
+/**
+ * @file RateLimiter.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a simple token bucket used to limit the rate of requests sent to AbuseIPDB.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_RATELIMITER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_RATELIMITER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <chrono>
+#include <mutex>
+
+namespace abuseipdb_client { namespace api {
+
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+    using std::mutex;
+
+    /**
+     * @brief A thread-safe token bucket.
+     * 
+     * Each request consumes one token; tokens are refilled at a constant rate up to a maximum burst size.
+     */
+    class RateLimiter {
+        public: // +++ Constructor / Destructor +++
+            RateLimiter(const double requestsPerSecond, const size_t burst = 1);
+            RateLimiter(const RateLimiter&) = delete;
+            virtual ~RateLimiter() {}
+
+        public: // +++ Token Management +++
+            void            acquire(); //!< Blocks until a token is available
+            bool            tryAcquire(); //!< Consumes a token if one is available
+
+            milliseconds    getWaitTime(); //!< Gets the time until the next token is available
+
+        private: // +++ Private API +++
+            void            refill();
+
+        private: // +++ Member Variables +++
+            double                      m_burst;
+            double                      m_requestsPerSecond;
+            double                      m_tokens;
+
+            mutex                       m_mutex;
+
+            steady_clock::time_point    m_lastRefill;
+    };
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_RATELIMITER_HPP
@@ -0,0 +1,96 @@
+/**
+ * @file ReportSuppressor.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a local table used to suppress reports AbuseIPDB would reject as duplicates.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_REPORTSUPPRESSOR_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_REPORTSUPPRESSOR_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace abuseipdb_client { namespace api {
+
+    using std::atomic;
+    using std::chrono::seconds;
+    using std::chrono::steady_clock;
+    using std::mutex;
+    using std::pair;
+    using std::string;
+    using std::unordered_map;
+    using std::vector;
+
+    /**
+     * @brief A time-bucketed table of recently reported IP addresses.
+     * 
+     * AbuseIPDB rejects reports of the same IP by the same user within 15 minutes.
+     * This table is consulted before sending a report; suppressed reports have their categories
+     * merged into the next report of the same IP which is allowed through.
+     * Entries are expired by a timer wheel with one slot per resolution interval; entries with pending categories
+     * are kept until the IP is reported again or they are collected with takePendingReports().
+     */
+    class ReportSuppressor {
+        public: // +++ Constants +++
+            const static seconds DEFAULT_SUPPRESSION_PERIOD; //!< 15 minutes
+            const static seconds DEFAULT_RESOLUTION; //!< 1 minute
+
+        public: // +++ Constructor / Destructor +++
+            explicit ReportSuppressor(const seconds period = DEFAULT_SUPPRESSION_PERIOD, const seconds resolution = DEFAULT_RESOLUTION);
+            ReportSuppressor(const ReportSuppressor&) = delete;
+            virtual ~ReportSuppressor() {}
+
+        public: // +++ Suppression +++
+            bool    tryReport(const string& ipAddress, uint64_t& categories, uint64_t& mergedCategories, const steady_clock::time_point now = steady_clock::now()); //!< Checks whether a report may be sent
+            void    forget(const string& ipAddress, const steady_clock::time_point now = steady_clock::now()); //!< Allows an IP to be reported again, e.g. if the report failed
+            void    forget(const string& ipAddress, const uint64_t restoredCategories, const steady_clock::time_point now = steady_clock::now()); //!< Allows an IP to be reported again, restoring the categories merged into the failed report
+
+            vector<pair<string, uint64_t>> takePendingReports(const steady_clock::time_point now = steady_clock::now()); //!< Removes and returns the suppressed categories of IPs which may be reported again
+
+        public: // +++ Getter +++
+            size_t  getSuppressedCount() const { return m_suppressedCount.load(std::memory_order_relaxed); }
+            size_t  size() const;
+
+        private: // +++ Private API +++
+            int64_t getTick(const steady_clock::time_point) const;
+            void    expire(const int64_t currentTick);
+
+        private: // +++ Types +++
+            struct Entry {
+                steady_clock::time_point    reportedAt;         //!< The time the last report was allowed through
+                int64_t                     tick;               //!< The wheel tick the entry was inserted at
+                uint64_t                    pendingCategories;  //!< The categories of all suppressed reports
+            };
+
+        private: // +++ Member Variables +++
+            int64_t                         m_lastTick;
+
+            mutable mutex                   m_mutex;
+
+            seconds                         m_period;
+            seconds                         m_resolution;
+
+            atomic<size_t>                  m_suppressedCount;
+
+            unordered_map<string, Entry>    m_entries;
+
+            vector<vector<string>>          m_wheel;
+    };
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_REPORTSUPPRESSOR_HPP
@@ -0,0 +1,73 @@
+/**
+ * @file RequestTiming.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the timing breakdown of a single request sent to AbuseIPDB.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_REQUESTTIMING_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_REQUESTTIMING_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// curl
+#include <curl/curl.h>
+
+namespace abuseipdb_client { namespace api {
+
+    using std::chrono::microseconds;
+    using std::function;
+    using std::string;
+
+    /**
+     * @brief The timing breakdown of a single transfer, as reported by libcurl.
+     *
+     * The timestamps are measured from the start of the transfer, so they are cumulative;
+     * use the get*Time() methods to get the duration of each individual phase.
+     * Phases which were skipped (e.g. DNS and TLS on a reused connection) end at the previous timestamp.
+     */
+    struct RequestTiming {
+        string          endpoint;           //!< The name of the API endpoint
+        CURLcode        result;             //!< The result of the transfer
+        long            httpStatus;         //!< The HTTP status; 0 if no response was received
+
+        microseconds    nameLookup;         //!< Until the name was resolved
+        microseconds    connect;            //!< Until the TCP connection was established
+        microseconds    appConnect;         //!< Until the TLS handshake completed; 0 without TLS
+        microseconds    startTransfer;      //!< Until the first byte of the response was received
+        microseconds    total;              //!< Until the transfer completed
+
+        uint64_t        bytesDownloaded;    //!< The size of the response body as received (before decompression)
+        uint64_t        bytesUploaded;      //!< The size of the request body
+
+        long            newConnections;     //!< The amount of connections opened for this transfer
+        bool            connectionReused;   //!< Whether an existing connection was reused
+
+        RequestTiming():
+            endpoint(), result(CURLcode::CURLE_OK), httpStatus(0),
+            nameLookup(0), connect(0), appConnect(0), startTransfer(0), total(0),
+            bytesDownloaded(0), bytesUploaded(0), newConnections(0), connectionReused(false) {}
+
+        microseconds    getNameLookupTime() const { return nameLookup; }
+        microseconds    getConnectTime() const { return std::max(connect - nameLookup, microseconds(0)); }
+        microseconds    getTlsTime() const { return appConnect.count() ? std::max(appConnect - connect, microseconds(0)) : microseconds(0); }
+        microseconds    getServerTime() const { return std::max(startTransfer - std::max(connect, appConnect), microseconds(0)); } //!< Sending the request until the first response byte
+        microseconds    getTransferTime() const { return std::max(total - startTransfer, microseconds(0)); } //!< Receiving the response
+    };
+
+    using RequestTraceCallback = function<void(const RequestTiming&)>; //!< Invoked once per finished transfer, on the thread which called the API
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_REQUESTTIMING_HPP
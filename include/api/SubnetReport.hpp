@@ -0,0 +1,71 @@
+/**
+ * @file SubnetReport.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a compact, indexed representation of the response of the check-block endpoint.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_API_SUBNETREPORT_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_API_SUBNETREPORT_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// nlohmann/json
+#include <nlohmann/json.hpp>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/CheckResult.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using nlohmann::json;
+
+    using std::string;
+    using std::vector;
+
+    /**
+     * @brief The reported addresses within an IPv4 subnet, sorted by address for quick lookups.
+     */
+    struct SubnetReport {
+        /**
+         * @brief A single reported address within the subnet.
+         */
+        struct ReportedAddress {
+            uint32_t    address;                //!< The IPv4 address in host byte order
+            uint32_t    numReports;             //!< The amount of reports
+            time_t      mostRecentReport;       //!< UNIX timestamp of the most recent report
+            uint8_t     abuseConfidenceScore;   //!< 0-100
+            char        countryCode[2];         //!< ISO 3166-1 alpha-2 code; zeroed if unknown
+        };
+
+        uint32_t                networkAddress;     //!< The network address in host byte order
+        uint8_t                 prefixLength;       //!< The length of the prefix (CIDR)
+
+        vector<ReportedAddress> reportedAddresses;  //!< All reported addresses, sorted by address
+        vector<string>          failedSubnets;      //!< Sub-prefixes (CIDR) which couldn't be checked when fanning out
+
+        SubnetReport(): networkAddress(0), prefixLength(0), reportedAddresses({}), failedSubnets({}) {}
+
+        bool                    contains(const uint32_t address) const; //!< Checks whether an address is within the subnet
+        const ReportedAddress*  find(const uint32_t address) const; //!< Finds a reported address; nullptr if it wasn't reported
+
+        CheckResult             getCheckResult(const uint32_t address) const; //!< Answers a check of a single address within the subnet
+    };
+
+    bool parseSubnetReport(const json& response, SubnetReport& result); //!< Parses the response of the check-block endpoint
+
+} /* namespace api */ } /* abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_API_SUBNETREPORT_HPP
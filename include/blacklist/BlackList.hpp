@@ -0,0 +1,89 @@
+/**
+ * @file BlackList.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a compact, immutable store for blacklists downloaded from AbuseIPDB.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLIST_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLIST_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// nlohmann/json
+#include <nlohmann/json.hpp>
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using nlohmann::json;
+
+    using std::array;
+    using std::shared_ptr;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    using Address = array<uint8_t, 16>; //!< An IPv6 address; IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d)
+
+    /**
+     * @brief A compact, immutable blacklist, sorted by address.
+     * 
+     * Each entry takes 32 bytes; lookups are a binary search.
+     */
+    class BlackList {
+        public: // +++ Types +++
+            /**
+             * @brief A single entry of the blacklist.
+             */
+            struct Entry {
+                Address     address;                //!< The address
+                time_t      lastReportedAt;         //!< UNIX timestamp of the last report
+                uint8_t     abuseConfidenceScore;   //!< 0-100
+                char        countryCode[2];         //!< ISO 3166-1 alpha-2 code; zeroed if unknown
+
+                string_view getCountryCode() const { return string_view(countryCode, countryCode[1] ? 2 : 0); }
+            };
+
+        public: // +++ Static +++
+            static shared_ptr<const BlackList> fromJson(const json& response); //!< Creates a blacklist from the response of getBlackList
+
+            static bool                         parseAddress(const string& address, Address& output); //!< Parses an IPv4 or IPv6 address
+
+        public: // +++ Constructor / Destructor +++
+            BlackList(vector<Entry>&& entries, const time_t generatedAt);
+            BlackList(const BlackList&) = delete;
+            virtual ~BlackList() {}
+
+        public: // +++ Lookup +++
+            const Entry*            find(const Address& address) const;
+            const Entry*            find(const string& address) const;
+
+        public: // +++ Getter +++
+            const vector<Entry>&    getEntries() const { return m_entries; }
+
+            size_t                  size() const { return m_entries.size(); }
+
+            time_t                  getGeneratedAt() const { return m_generatedAt; }
+
+        private: // +++ Member Variables +++
+            time_t                  m_generatedAt;
+
+            vector<Entry>           m_entries;
+    };
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLIST_HPP
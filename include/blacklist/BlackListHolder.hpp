@@ -0,0 +1,81 @@
+/**
+ * @file BlackListHolder.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a double-buffered container which lets a refresher replace a blacklist while other threads look it up.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTHOLDER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTHOLDER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// nlohmann/json
+#include <nlohmann/json.hpp>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/BlackList.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using nlohmann::json;
+
+    using std::atomic;
+    using std::shared_ptr;
+    using std::string;
+
+    /**
+     * @brief Holds the current generation of a blacklist.
+     * 
+     * Readers take an immutable snapshot with a single atomic load and keep it alive for as long as they need it;
+     * a refresher parses the next list off to the side and publishes it with a single atomic store.
+     * Readers therefore never wait for a list to be downloaded or parsed and never observe a partially loaded list.
+     * Note that atomic<shared_ptr> is not lock-free in libstdc++: loads and stores briefly take an internal lock
+     * (for the duration of a reference count update), so concurrent readers and the publisher may wait on each other for that long.
+     */
+    class BlackListHolder {
+        public: // +++ Types +++
+            /**
+             * @brief An immutable generation of the blacklist.
+             */
+            struct Snapshot {
+                shared_ptr<const BlackList> list;       //!< The list; nullptr before the first publication
+                uint64_t                    generation; //!< Incremented by each publication; 0 before the first
+            };
+
+        public: // +++ Constructor / Destructor +++
+            BlackListHolder(shared_ptr<const BlackList> list = nullptr);
+            BlackListHolder(const BlackListHolder&) = delete;
+            virtual ~BlackListHolder() {}
+
+        public: // +++ Publishing +++
+            uint64_t                    publish(shared_ptr<const BlackList> list); //!< Atomically replaces the current generation
+            uint64_t                    publish(const json& response); //!< Parses the response of getBlackList and publishes it
+
+        public: // +++ Lookup +++
+            bool                        find(const string& address, BlackList::Entry& output) const; //!< Looks up an address in the current generation
+
+        public: // +++ Getter +++
+            shared_ptr<const Snapshot>  getSnapshot() const { return m_snapshot.load(std::memory_order_acquire); }
+
+            uint64_t                    getGeneration() const { return getSnapshot()->generation; }
+
+        private: // +++ Member Variables +++
+            atomic<shared_ptr<const Snapshot>>  m_snapshot;
+    };
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTHOLDER_HPP
@@ -0,0 +1,76 @@
+/**
+ * @file BlackListView.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains filtered views onto a BlackList, which allow deriving several blacklists from a single download.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTVIEW_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTVIEW_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/AbuseIpDbApi.hpp"
+#include "blacklist/BlackList.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using api::AbuseIpDbApi;
+
+    using std::shared_ptr;
+    using std::string;
+    using std::vector;
+
+    /**
+     * @brief A filtered view onto a BlackList.
+     * 
+     * The view applies the same options AbuseIPDB would apply on the server (confidence threshold, country filters, limit),
+     * but only stores the indices of the matching entries; the entries themselves are shared with the underlying list.
+     * Fetch the broadest list once (see getBroadestOptions) and derive a view per consumer.
+     * The broadest list has no country filters, so views with country filters are only complete if it wasn't truncated
+     * by its limit; getBroadestOptions() therefore requests the plan maximum whenever a view filters by country.
+     */
+    class BlackListView {
+        public: // +++ Static +++
+            static vector<shared_ptr<const BlackListView>> createViews(shared_ptr<const BlackList> list, const vector<AbuseIpDbApi::BlackListOptions>& options); //!< Derives several views in parallel
+
+            static AbuseIpDbApi::BlackListOptions getBroadestOptions(const vector<AbuseIpDbApi::BlackListOptions>& options, const size_t maxLimit = AbuseIpDbApi::MAX_IPS_BASIC_SUB); //!< Gets the options for a list all views can be derived from
+
+        public: // +++ Constructor / Destructor +++
+            BlackListView(shared_ptr<const BlackList> list, const AbuseIpDbApi::BlackListOptions& options);
+            BlackListView(const BlackListView&) = delete;
+            virtual ~BlackListView() {}
+
+        public: // +++ Lookup +++
+            const BlackList::Entry*         find(const Address& address) const;
+            const BlackList::Entry*         find(const string& address) const;
+
+            const BlackList::Entry&         operator[](const size_t index) const { return m_list->getEntries()[m_indices[index]]; }
+
+        public: // +++ Getter +++
+            shared_ptr<const BlackList>     getBlackList() const { return m_list; }
+
+            size_t                          size() const { return m_indices.size(); }
+
+        private: // +++ Member Variables +++
+            shared_ptr<const BlackList>     m_list;
+
+            vector<uint32_t>                m_indices; //!< Indices into the list; ascending, so they are sorted by address
+    };
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_BLACKLISTVIEW_HPP
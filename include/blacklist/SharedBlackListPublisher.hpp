@@ -0,0 +1,80 @@
+/**
+ * @file SharedBlackListPublisher.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the publisher which makes a blacklist available to other local processes via shared memory.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTPUBLISHER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTPUBLISHER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// spdlog
+#include <spdlog/spdlog.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/BlackList.hpp"
+#include "blacklist/BlackListHolder.hpp"
+#include "blacklist/SharedBlackListReader.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using spdlog::logger;
+
+    using std::shared_ptr;
+    using std::string;
+
+    /**
+     * @brief Publishes blacklists into a named shared-memory region (see SharedBlackListReader).
+     * 
+     * This allows a single daemon per host to download the blacklist, while all other local consumers
+     * map the region read-only and look addresses up without copying.
+     * The region is left in place when the publisher is destroyed, so consumers keep the last list; use unlink() to remove it.
+     */
+    class SharedBlackListPublisher {
+        public: // +++ Static +++
+            const static size_t DEFAULT_CAPACITY; //!< Default max. no. of entries
+
+            static bool unlink(const string& name); //!< Removes the shared-memory region
+
+        public: // +++ Constructor / Destructor +++
+            SharedBlackListPublisher(const string& name, shared_ptr<logger> logger, const size_t capacity = DEFAULT_CAPACITY);
+            SharedBlackListPublisher(const SharedBlackListPublisher&) = delete;
+            virtual ~SharedBlackListPublisher();
+
+        public: // +++ Publishing +++
+            bool    publish(const BlackList& list, const uint64_t generation); //!< Writes a list into the region
+            bool    publish(const BlackListHolder& holder); //!< Writes the current generation of a holder into the region
+
+        public: // +++ Getter +++
+            size_t  getCapacity() const { return m_header->capacity; }
+
+            string  getName() const { return m_name; }
+
+        private: // +++ Member Variables +++
+            SharedBlackListEntry*   m_entries;
+
+            SharedBlackListHeader*  m_header;
+
+            shared_ptr<logger>      m_logger;
+
+            size_t                  m_mappingSize;
+
+            string                  m_name;
+    };
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTPUBLISHER_HPP
@@ -0,0 +1,342 @@
+/**
+ * @file SharedBlackListReader.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the layout of the shared-memory blacklist and a header-only reader for it.
+ * 
+ * This header deliberately depends on nothing but the standard library and POSIX,
+ * so local consumers (proxies, mail filters, ...) can look up the blacklist published by the daemon
+ * without linking against this library.
+ * 
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTREADER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTREADER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using std::array;
+    using std::atomic;
+    using std::chrono::microseconds;
+    using std::mutex;
+    using std::string;
+    using std::unique_ptr;
+    using std::vector;
+
+    using Address = array<uint8_t, 16>; //!< An IPv6 address; IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d)
+
+    constexpr char      SHARED_BLACKLIST_MAGIC[8] = { 'A', 'B', 'I', 'P', 'D', 'B', 'B', 'L' };
+    constexpr uint32_t  SHARED_BLACKLIST_VERSION = 2;
+
+    /**
+     * @brief A single entry of the shared blacklist. Identical in layout to BlackList::Entry.
+     */
+    struct SharedBlackListEntry {
+        Address     address;                //!< The address
+        time_t      lastReportedAt;         //!< UNIX timestamp of the last report
+        uint8_t     abuseConfidenceScore;   //!< 0-100
+        char        countryCode[2];         //!< ISO 3166-1 alpha-2 code; zeroed if unknown
+    };
+
+    /**
+     * @brief The header at the start of the shared-memory region; the entries (sorted by address) follow it directly.
+     * 
+     * The header and entries are guarded by a seqlock: the sequence is odd while the publisher is writing,
+     * and readers retry whenever it changed during their lookup.
+     * When the publisher replaces the region (e.g. with a different capacity), it sets isRetired in the old region
+     * before unlinking it, so readers know to map the new one.
+     */
+    struct SharedBlackListHeader {
+        char                magic[8];       //!< SHARED_BLACKLIST_MAGIC
+        uint32_t            version;        //!< SHARED_BLACKLIST_VERSION
+        uint32_t            entrySize;      //!< sizeof(SharedBlackListEntry)
+        uint64_t            capacity;       //!< The max no. of entries the region can hold; fixed when the region is created
+
+        atomic<uint64_t>    sequence;       //!< Seqlock sequence; odd while a new list is being written
+        atomic<uint64_t>    generation;     //!< Generation of the published list; 0 if none has been published yet
+        atomic<int64_t>     generatedAt;    //!< UNIX timestamp at which AbuseIPDB generated the list
+        atomic<uint64_t>    count;          //!< The no. of entries in the list
+        atomic<uint32_t>    isRetired;      //!< Non-zero once the region was replaced by a new one under the same name
+    };
+
+    static_assert(sizeof(SharedBlackListEntry) == 32, "Shared blacklist entries must be 32 bytes");
+    static_assert(atomic<uint64_t>::is_always_lock_free, "Shared blacklist requires lock-free 64-bit atomics");
+    static_assert(atomic<uint32_t>::is_always_lock_free, "Shared blacklist requires lock-free 32-bit atomics");
+
+    /**
+     * @brief Gets the size of a shared blacklist region holding up to capacity entries.
+     */
+    inline size_t getSharedBlackListSize(const uint64_t capacity) {
+        return sizeof(SharedBlackListHeader) + capacity * sizeof(SharedBlackListEntry);
+    }
+
+    /**
+     * @brief Read-only, zero-copy access to a blacklist published into shared memory.
+     * 
+     * Lookups never block the publisher; a lookup which overlaps a publication is retried until READ_TIMEOUT elapses,
+     * after which it reports the list as unavailable (e.g. because the publisher died mid-write).
+     * If the publisher replaces the region, the next lookup maps the new one. Replaced mappings are kept until close(),
+     * so lookups in other threads never touch unmapped memory.
+     * A reader may be shared between threads.
+     */
+    class SharedBlackListReader {
+        public: // +++ Types +++
+            /**
+             * @brief The result of a lookup.
+             */
+            enum class LookupResult: uint8_t {
+                Found,          //!< The address is listed
+                NotFound,       //!< The address is not listed
+                Unavailable     //!< The list could not be read (not open, or a write did not complete in time)
+            };
+
+        public: // +++ Constants +++
+            constexpr static microseconds READ_TIMEOUT = microseconds(10'000); //!< Max. time a lookup waits for a publication to complete
+
+        public: // +++ Static +++
+            /**
+             * @brief Parses an IPv4 or IPv6 address; IPv4 addresses are IPv4-mapped.
+             */
+            static bool parseAddress(const string& address, Address& output) {
+                output.fill(0);
+
+                if (inet_pton(AF_INET6, address.c_str(), output.data()) == 1) { return true; }
+                if (inet_pton(AF_INET, address.c_str(), output.data() + 12) != 1) { return false; }
+
+                output[10] = 0xff;
+                output[11] = 0xff;
+                return true;
+            }
+
+        public: // +++ Constructor / Destructor +++
+            SharedBlackListReader(): m_mapping(nullptr) {}
+            SharedBlackListReader(const SharedBlackListReader&) = delete;
+            virtual ~SharedBlackListReader() { close(); }
+
+        public: // +++ Open / Close +++
+            /**
+             * @brief Maps the shared blacklist with the given name (e.g. "/abuseipdb-blacklist").
+             * 
+             * Must not be called while other threads are looking up addresses.
+             * 
+             * @return true If the region exists and is a compatible blacklist.
+             */
+            bool open(const string& name) {
+                close();
+
+                std::lock_guard<mutex> lock(m_mutex);
+                m_name = name;
+
+                auto mapping = mapRegion(name);
+                if (!mapping) { return false; }
+
+                m_mapping.store(mapping.get(), std::memory_order_release);
+                m_mappings.push_back(std::move(mapping));
+
+                return true;
+            }
+
+            /**
+             * @brief Unmaps the shared blacklist.
+             * 
+             * Must not be called while other threads are looking up addresses.
+             */
+            void close() {
+                std::lock_guard<mutex> lock(m_mutex);
+
+                m_mapping.store(nullptr, std::memory_order_release);
+                m_mappings.clear();
+            }
+
+            bool isOpen() const { return m_mapping.load(std::memory_order_acquire) != nullptr; }
+
+        public: // +++ Lookup +++
+            /**
+             * @brief Looks up an address.
+             * 
+             * @param address The address.
+             * @param output The entry, copied out of shared memory.
+             * 
+             * @return LookupResult Whether the address is listed, or Unavailable if the list couldn't be read.
+             */
+            LookupResult lookup(const Address& address, SharedBlackListEntry& output) {
+                const auto* mapping = getCurrentMapping();
+                if (!mapping) { return LookupResult::Unavailable; }
+
+                const auto* header = mapping->header;
+                const auto* entries = mapping->entries;
+                const auto deadline = std::chrono::steady_clock::now() + READ_TIMEOUT;
+
+                do {
+                    const auto sequence = header->sequence.load(std::memory_order_acquire);
+                    if (sequence & 1) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    auto first = size_t(0);
+                    auto last = std::min<size_t>(header->count.load(std::memory_order_relaxed), header->capacity);
+
+                    while (first < last) {
+                        const auto middle = first + (last - first) / 2;
+
+                        if (std::memcmp(entries[middle].address.data(), address.data(), address.size()) < 0) {
+                            first = middle + 1;
+                        } else {
+                            last = middle;
+                        }
+                    }
+
+                    const auto isFound = first < header->count.load(std::memory_order_relaxed) && first < header->capacity &&
+                                         std::memcmp(entries[first].address.data(), address.data(), address.size()) == 0;
+                    if (isFound) { std::memcpy(&output, &entries[first], sizeof(SharedBlackListEntry)); }
+
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (header->sequence.load(std::memory_order_relaxed) == sequence) {
+                        return isFound ? LookupResult::Found : LookupResult::NotFound;
+                    }
+                } while (std::chrono::steady_clock::now() < deadline);
+
+                return LookupResult::Unavailable;
+            }
+
+            /**
+             * @brief Looks up a textual IPv4 or IPv6 address.
+             */
+            LookupResult lookup(const string& address, SharedBlackListEntry& output) {
+                Address parsedAddress{};
+
+                return parseAddress(address, parsedAddress) ? lookup(parsedAddress, output) : LookupResult::NotFound;
+            }
+
+            /**
+             * @brief Checks whether an address is listed.
+             * 
+             * @return true If the address is listed; false if it isn't or the list is unavailable (see lookup()).
+             */
+            bool find(const Address& address, SharedBlackListEntry& output) { return lookup(address, output) == LookupResult::Found; }
+            bool find(const string& address, SharedBlackListEntry& output) { return lookup(address, output) == LookupResult::Found; }
+
+        public: // +++ Getter +++
+            uint64_t    getGeneration() {
+                const auto* mapping = getCurrentMapping();
+                return mapping ? mapping->header->generation.load(std::memory_order_acquire) : 0;
+            }
+
+            time_t      getGeneratedAt() {
+                const auto* mapping = getCurrentMapping();
+                return mapping ? mapping->header->generatedAt.load(std::memory_order_acquire) : 0;
+            }
+
+            size_t      size() {
+                const auto* mapping = getCurrentMapping();
+                return mapping ? mapping->header->count.load(std::memory_order_acquire) : 0;
+            }
+
+        private: // +++ Mapping +++
+            /**
+             * @brief A single read-only mapping of a region.
+             */
+            struct Mapping {
+                const SharedBlackListHeader*    header;
+                const SharedBlackListEntry*     entries;
+                size_t                          size;
+
+                Mapping(const SharedBlackListHeader* h, const size_t s):
+                    header(h), entries(reinterpret_cast<const SharedBlackListEntry*>(h + 1)), size(s) {}
+                Mapping(const Mapping&) = delete;
+                ~Mapping() { munmap(const_cast<SharedBlackListHeader*>(header), size); }
+            };
+
+            /**
+             * @brief Maps and validates a region.
+             * 
+             * @return The mapping, or nullptr if the region doesn't exist or is incompatible.
+             */
+            static unique_ptr<Mapping> mapRegion(const string& name) {
+                const auto fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+                if (fd < 0) { return nullptr; }
+
+                struct stat regionStat{};
+                if (fstat(fd, &regionStat) != 0 || static_cast<size_t>(regionStat.st_size) < sizeof(SharedBlackListHeader)) {
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                auto* region = mmap(nullptr, regionStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                ::close(fd);
+                if (region == MAP_FAILED) { return nullptr; }
+
+                auto mapping = std::make_unique<Mapping>(static_cast<const SharedBlackListHeader*>(region), regionStat.st_size);
+                const auto* header = mapping->header;
+
+                if (std::memcmp(header->magic, SHARED_BLACKLIST_MAGIC, sizeof(SHARED_BLACKLIST_MAGIC)) != 0 ||
+                    header->version != SHARED_BLACKLIST_VERSION || header->entrySize != sizeof(SharedBlackListEntry) ||
+                    getSharedBlackListSize(header->capacity) > mapping->size) {
+                    return nullptr;
+                }
+
+                return mapping;
+            }
+
+            /**
+             * @brief Gets the current mapping, mapping the replacement first if the publisher retired it.
+             * 
+             * @return The mapping to read from; nullptr if the reader isn't open.
+             */
+            const Mapping* getCurrentMapping() {
+                const auto* mapping = m_mapping.load(std::memory_order_acquire);
+                if (!mapping || !mapping->header->isRetired.load(std::memory_order_acquire)) { return mapping; }
+
+                std::lock_guard<mutex> lock(m_mutex);
+                if (m_mapping.load(std::memory_order_relaxed) != mapping) { return m_mapping.load(std::memory_order_relaxed); } // remapped by another thread
+
+                auto replacement = mapRegion(m_name);
+                if (!replacement) { return mapping; } // not created yet; keep reading the last list
+
+                m_mapping.store(replacement.get(), std::memory_order_release);
+                m_mappings.push_back(std::move(replacement));
+
+                return m_mappings.back().get();
+            }
+
+        private: // +++ Member Variables +++
+            atomic<const Mapping*>          m_mapping;      //!< The mapping lookups read from
+
+            mutex                           m_mutex;        //!< Guards remapping
+
+            string                          m_name;
+
+            vector<unique_ptr<Mapping>>     m_mappings;     //!< All mappings made since open(); retired ones are kept until close()
+    };
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_BLACKLIST_SHAREDBLACKLISTREADER_HPP
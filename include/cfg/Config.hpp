@@ -0,0 +1,99 @@
+/**
+ * @file Config.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the typed, validated and immutable representation of the application's configuration.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_INCLUDE_CFG_CONFIG_HPP
+#define ABUSEIPDB_INCLUDE_CFG_CONFIG_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// json
+#include <nlohmann/json.hpp>
+
+namespace abuseipdb_client { namespace cfg {
+
+    using nlohmann::json;
+
+    using std::chrono::seconds;
+    using std::shared_ptr;
+    using std::string;
+
+    /**
+     * @brief The application's configuration, deserialised and validated once when it is loaded.
+     * 
+     * Values missing from the config file are taken from the embedded default config.
+     * Components hold a snapshot (shared_ptr<const Config>), so reading a value is a plain field load.
+     */
+    struct Config {
+        /**
+         * @brief Settings related to the AbuseIPDB website.
+         */
+        struct AbuseIpDbConfig {
+            string      apiKey;                 //!< AbuseIpDb.ApiKey
+        };
+
+        /**
+         * @brief Settings related to reporting.
+         */
+        struct ReportingConfig {
+            seconds     aggregationWindow;      //!< Reporting.AggregationWindowSeconds; 0 disables aggregation
+        };
+
+        /**
+         * @brief Settings related to Fail2Ban.
+         */
+        struct Fail2BanConfig {
+            bool        isEnabled;              //!< Fail2Ban.Enabled
+            string      dbFile;                 //!< Fail2Ban.DbFile
+        };
+
+        /**
+         * @brief Settings related to endlessh.
+         */
+        struct EndlesshConfig {
+            bool        isEnabled;              //!< Endlessh.Enabled
+            bool        useEndlesshReport;      //!< Endlessh.UseEndlesshReport
+        };
+
+        /**
+         * @brief Settings related to the MQTT API.
+         */
+        struct MqttConfig {
+            string      brokerAddress;          //!< Mqtt.BrokerAddress
+            uint16_t    brokerPort;             //!< Mqtt.BrokerPort
+            string      username;               //!< Mqtt.Username
+            string      password;               //!< Mqtt.Password
+        };
+
+        bool            runAsDaemon;            //!< RunAsDaemon
+        seconds         wakeupTime;             //!< WakeupTimeSeconds
+
+        AbuseIpDbConfig abuseIpDb;
+        ReportingConfig reporting;
+        Fail2BanConfig  fail2Ban;
+        EndlesshConfig  endlessh;
+        MqttConfig      mqtt;
+
+        static shared_ptr<const Config> fromJson(const json& config); //!< Deserialises and validates a config; throws ConfigException listing all errors
+        static shared_ptr<const Config> getDefaultConfig(); //!< Gets the default config, built from the values embedded at compile time
+        static const json&              getDefaults(); //!< Gets the parsed embedded default config
+
+        json                            toJson() const; //!< Serialises the config in the layout of config.json
+    };
+
+} /* namespace cfg */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_INCLUDE_CFG_CONFIG_HPP
@@ -15,9 +15,17 @@
 //  SYSTEM INCLUDES  //
 ///////////////////////
 // stl
+#include <atomic>
 #include <exception>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 // json
 #include <nlohmann/json.hpp>
@@ -28,6 +36,7 @@
 ///////////////////////
 //  LOCAL  INCLUDES  //
 ///////////////////////
+#include "cfg/Config.hpp"
 #include "util/Utilities.hpp"
 
 namespace abuseipdb_client { namespace cfg {
@@ -36,11 +45,40 @@ namespace abuseipdb_client { namespace cfg {
 
     using spdlog::logger;
 
+    using std::atomic;
     using std::exception;
+    using std::function;
+    using std::map;
+    using std::mutex;
+    using std::shared_mutex;
     using std::shared_ptr;
     using std::string;
+    using std::string_view;
+    using std::thread;
+    using std::unordered_map;
 
-    class ConfigException;
+    using ConfigListener = function<void(shared_ptr<const Config>)>; //!< Invoked with each newly published config
+
+    /**
+     * @brief Thrown when a requested config doesn't exist or is invalid.
+     */
+    class ConfigException: public exception {
+        public: // +++ Constructor / Destructor +++
+            ConfigException(const string& configObj, const string& error):
+                m_config(configObj), m_error(error), m_message(spdlog::fmt_lib::format("{0:s}; Config object {1:s}", error, configObj)) {}
+            ~ConfigException() {}
+
+        public: // +++ Exposed API +++
+            const char* what() const noexcept override { return m_message.c_str(); }
+
+            string      getConfig() const { return m_config; }
+            string      getError() const { return m_error; }
+
+        private: // +++ Private API +++
+            const string    m_config;
+            const string    m_error;
+            const string    m_message;
+    };
 
     /**
      * @brief Simple class providing basic functionality for a working config.
@@ -54,71 +92,113 @@ namespace abuseipdb_client { namespace cfg {
 
         public: // +++ Constructor / Destructor +++
                                             ConfigManager(const ConfigManager&) = delete;
-            virtual ~                       ConfigManager() {}
+            virtual ~                       ConfigManager() { stopWatching(); }
 
         public: // +++ Setter / Setter +++
             virtual string                  getConfigPath() const { return m_cfgPath; }
 
-            virtual void                    setConfigPath(const string& val) { m_cfgPath = val; }
+            shared_ptr<const Config>        getSnapshot() const { return m_state.load(std::memory_order_acquire)->config; } //!< Gets the current typed config
+
+            bool                            isWatching() const { return m_isWatching; }
+
+            virtual void                    setConfigPath(const string& val) { m_cfgPath = val; } //!< A running watcher keeps watching the previous path until it is restarted
             virtual void                    setLogger(shared_ptr<logger> val) { if (m_logger) { return; } m_logger = val; }
 
         public: // +++ Config Management +++
             virtual void                    loadConfigs();
 
+        public: // +++ Hot Reload +++
+            virtual void                    startWatching(); //!< Reloads the config whenever the config file changes
+            virtual void                    stopWatching();
+
+            size_t                          addListener(ConfigListener listener); //!< Registers a callback for reloaded configs
+            void                            removeListener(const size_t listenerId);
+
         public: // +++ Config Getters / Setters +++
-            virtual bool                    hasConfig(const string& config) const;
+            static json::json_pointer       compilePath(const string_view path); //!< Compiles a dotted path ("Fail2Ban.DbFile") into a JSON pointer
 
+            virtual bool                    hasConfig(const string_view config) const;
+            virtual bool                    hasConfig(const json::json_pointer& config) const;
+
+            /**
+             * @brief Gets a config by its dotted path. The path is compiled once and cached.
+             */
+            template<class T>
+            T                               getConfig(const string_view path) const {
+                return getConfig<T>(m_state.load(std::memory_order_acquire)->configObj, getCompiledPath(path));
+            }
+
+            /**
+             * @brief Gets a config by a path previously compiled with compilePath.
+             */
             template<class T>
-            T                               getConfig(const string& path) const {
-                return getConfig<T>(m_configObj, path);
+            T                               getConfig(const json::json_pointer& path) const {
+                return getConfig<T>(m_state.load(std::memory_order_acquire)->configObj, path);
             }
 
         protected: // +++ Constructor +++
                                             ConfigManager();
 
         protected: // +++ Protected API +++
-            virtual bool                    hasConfig(const json& container, const string& path) const;
+            const json::json_pointer&       getCompiledPath(const string_view path) const;
+
+            virtual bool                    hasConfig(const json& container, const json::json_pointer& path) const;
+
+            virtual bool                    reloadConfigs(const string& configPath);
+
+            void                            publishConfig(const string& configString, const string& configPath);
+
+            void                            watchConfigFile(const string configPath);
 
             template<class T>
-            T                               getConfig(const json& container, const string& path) const {
+            T                               getConfig(const json& container, const json::json_pointer& path) const {
                 if (!hasConfig(container, path)) {
-                    throw ConfigException("Attempt to retrieve non-existing config!", path);
+                    throw ConfigException(path.to_string(), "Attempt to retrieve non-existing config!");
                 }
 
-                if (utils::regexMatch(path, CONFIG_PATTERN)) {
-                    const auto tokens = utils::splitString(path, ".");
-                    if (!hasConfig(container, tokens.front())) {
-                        throw ConfigException(tokens.front(), "Requested config not found!");
-                    }
+                return container.at(path).get<T>();
+            }
+
+        private: // +++ Types +++
+            /**
+             * @brief A published config; the typed config and the JSON it was deserialised from are swapped together.
+             */
+            struct ConfigState {
+                shared_ptr<const Config>    config;
+                json                        configObj;
+            };
 
-                    return getConfig<T>(container.at(tokens.front()), utils::replaceString(const_cast<string&>(path), tokens.front() + ".", ""));
-                }
+            /**
+             * @brief Transparent hash, so the path cache can be searched without constructing a string.
+             */
+            struct PathHash {
+                using is_transparent = void;
 
-                return container.at(path);
-            }
+                size_t operator()(const string_view path) const { return std::hash<string_view>{}(path); }
+            };
 
         private:
-            json                            m_configObj;
+            atomic<bool>                    m_isWatching;
 
-            shared_ptr<logger>  	        m_logger;
+            atomic<shared_ptr<const ConfigState>> m_state;
 
-            string                          m_cfgPath;
+            map<size_t, ConfigListener>     m_listeners;
 
-        
-    };
+            mutex                           m_listenerMutex;
 
-    class ConfigException: exception {
-        public: // +++ Constructor / Destructor +++
-            ConfigException(const string& configObj, const string& error):
-                m_config(configObj), m_error(error) {}
-            ~ConfigException() {}
+            mutable shared_mutex            m_pathCacheMutex;
 
-        public: // +++ Exposed API +++
-            const char* what() { return spdlog::fmt_lib::format("{0:s}; Config object {1:s}", m_error, m_config).c_str(); }
+            mutable unordered_map<string, json::json_pointer, PathHash, std::equal_to<>> m_pathCache;
 
-        private: // +++ Private API +++
-            const string    m_config;
-            const string    m_error;
+            shared_ptr<logger>  	        m_logger;
+
+            size_t                          m_nextListenerId;
+
+            string                          m_cfgPath;
+
+            thread                          m_watchThread;
+
+        
     };
 
 } /* namespace cfg */ } /* namespace abuseipdb_client */
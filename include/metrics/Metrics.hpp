@@ -0,0 +1,124 @@
+/**
+ * @file Metrics.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the metric types (counters, gauges and latency histograms) used to observe the client.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICS_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICS_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace abuseipdb_client { namespace metrics {
+
+    using std::array;
+    using std::atomic;
+
+    constexpr size_t SHARD_COUNT = 16; //!< The amount of per-thread shards per metric
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    size_t getShardIndex(); //!< Gets the shard the calling thread writes to
+
+    /**
+     * @brief A monotonically increasing counter.
+     *
+     * Increments are spread across cache-line-padded shards; reading sums all shards.
+     */
+    class Counter {
+        public: // +++ Constructor / Destructor +++
+            Counter() = default;
+            Counter(const Counter&) = delete;
+            virtual ~Counter() = default;
+
+        public: // +++ Recording +++
+            void        increment(const uint64_t value = 1);
+
+            uint64_t    get() const;
+
+        private: // +++ Shards +++
+            struct alignas(CACHE_LINE_SIZE) Shard {
+                atomic<uint64_t> value{0};
+            };
+
+        private: // +++ Member Variables +++
+            array<Shard, SHARD_COUNT> m_shards;
+    };
+
+    /**
+     * @brief A value which may go up and down, such as the remaining API quota.
+     */
+    class Gauge {
+        public: // +++ Constructor / Destructor +++
+            Gauge() = default;
+            Gauge(const Gauge&) = delete;
+            virtual ~Gauge() = default;
+
+        public: // +++ Recording +++
+            void    add(const double value) { m_value.fetch_add(value, std::memory_order_relaxed); }
+            void    set(const double value) { m_value.store(value, std::memory_order_relaxed); }
+
+            double  get() const { return m_value.load(std::memory_order_relaxed); }
+
+        private: // +++ Member Variables +++
+            atomic<double> m_value{0};
+    };
+
+    /**
+     * @brief A latency histogram with log-linear buckets, in the style of HdrHistogram.
+     *
+     * Values are recorded in microseconds. Values below 16µs are counted exactly; above that, each power of two
+     * is split into 16 linear sub-buckets, which bounds the relative error of any percentile to 6.25%
+     * while covering the full 64-bit range in a fixed amount of memory.
+     *
+     * The count and sum are sharded like Counter, but the buckets are not, which would take 16 times the memory (~125KiB per histogram).
+     * Concurrent observations of similar values therefore contend on the same bucket.
+     */
+    class Histogram {
+        public: // +++ Static +++
+            constexpr static uint32_t SUB_BUCKET_BITS = 4;
+            constexpr static uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+            constexpr static size_t   BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT;
+
+            static size_t   getBucketIndex(const uint64_t micros);
+            static uint64_t getBucketLowerBound(const size_t index);
+            static uint64_t getBucketUpperBound(const size_t index); //!< Exclusive
+
+        public: // +++ Constructor / Destructor +++
+            Histogram() = default;
+            Histogram(const Histogram&) = delete;
+            virtual ~Histogram() = default;
+
+        public: // +++ Recording +++
+            void        observe(const double seconds);
+            void        observeMicros(const uint64_t micros);
+
+        public: // +++ Reading +++
+            uint64_t    getCount() const;
+            uint64_t    getCountAtOrBelow(const uint64_t micros) const;
+            uint64_t    getPercentile(const double percentile) const;
+            uint64_t    getSumMicros() const;
+
+        private: // +++ Shards +++
+            struct alignas(CACHE_LINE_SIZE) Shard {
+                atomic<uint64_t> count{0};
+                atomic<uint64_t> sum{0};
+            };
+
+        private: // +++ Member Variables +++
+            array<Shard, SHARD_COUNT>               m_shards;
+            array<atomic<uint64_t>, BUCKET_COUNT>   m_buckets{};
+    };
+
+} /* namespace metrics */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICS_HPP
@@ -0,0 +1,112 @@
+/**
+ * @file MetricsRegistry.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the registry which owns all metrics and exports them in the Prometheus text format.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICSREGISTRY_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICSREGISTRY_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "metrics/Metrics.hpp"
+
+namespace abuseipdb_client { namespace metrics {
+
+    using std::chrono::milliseconds;
+    using std::condition_variable;
+    using std::map;
+    using std::mutex;
+    using std::pair;
+    using std::shared_mutex;
+    using std::shared_ptr;
+    using std::string;
+    using std::thread;
+    using std::vector;
+
+    using Labels = vector<pair<string, string>>; //!< Label names and values attached to a single series
+
+    /**
+     * @brief Owns all metrics of the application and exports them.
+     *
+     * Metrics are grouped into families by name; each family holds one series per distinct set of labels.
+     * Looking up a series is meant to happen rarely (callers should keep the returned pointer),
+     * while recording values never touches the registry.
+     *
+     * The registry can either be serialised on demand or written periodically to a file for node_exporter's
+     * textfile collector.
+     */
+    class MetricsRegistry {
+        public: // +++ Static +++
+            const static vector<double> DEFAULT_LATENCY_BOUNDS; //!< The upper bounds (in seconds) exported for histograms
+
+            static string   escapeLabelValue(const string& value);
+            static string   formatLabels(const Labels& labels);
+
+        public: // +++ Constructor / Destructor +++
+            MetricsRegistry() = default;
+            MetricsRegistry(const MetricsRegistry&) = delete;
+            virtual ~MetricsRegistry();
+
+        public: // +++ Metrics +++
+            shared_ptr<Counter>     getCounter(const string& name, const string& help, const Labels& labels = {});
+            shared_ptr<Gauge>       getGauge(const string& name, const string& help, const Labels& labels = {});
+            shared_ptr<Histogram>   getHistogram(const string& name, const string& help, const Labels& labels = {});
+
+        public: // +++ Export +++
+            bool                    writeTextfile(const string& path) const;
+
+            string                  serialise() const;
+
+            void                    startTextfileWriter(const string& path, const milliseconds interval);
+            void                    stopTextfileWriter();
+
+        private: // +++ Families +++
+            template<typename T>
+            struct Family {
+                string                              help;
+                map<string, shared_ptr<T>>          series; //!< Keyed by the formatted labels
+            };
+
+            template<typename T>
+            shared_ptr<T>           getMetric(map<string, Family<T>>& families, const string& name, const string& help, const Labels& labels);
+
+        private: // +++ Member Variables +++
+            bool                                m_stopWriter{false};
+
+            condition_variable                  m_writerCondition;
+
+            map<string, Family<Counter>>        m_counters;
+            map<string, Family<Gauge>>          m_gauges;
+            map<string, Family<Histogram>>      m_histograms;
+
+            mutable shared_mutex                m_mutex;
+
+            mutex                               m_writerMutex;
+
+            thread                              m_writerThread;
+    };
+
+} /* namespace metrics */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_METRICS_METRICSREGISTRY_HPP
@@ -0,0 +1,100 @@
+/**
+ * @file ReportAggregator.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the declaration of an aggregation stage merging reports of the same IP.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTAGGREGATOR_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTAGGREGATOR_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/AbuseIpDbApi.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using api::AbuseIpDbApi;
+
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+    using std::deque;
+    using std::function;
+    using std::mutex;
+    using std::string;
+    using std::unordered_map;
+    using std::unordered_set;
+
+    /**
+     * @brief Merges reports of the same IP over a configurable window into a single report.
+     * 
+     * The categories of all reports are OR'd together and their (distinct) comments are concatenated
+     * and truncated to the maximum length accepted by AbuseIPDB.
+     * The window of an IP starts with its first report; once it has elapsed, the merged report
+     * is emitted by poll() through the callback.
+     * A window of zero disables aggregation: each report is emitted by add() right away.
+     */
+    class ReportAggregator {
+        public: // +++ Typedefs +++
+            using ReportCallback = function<void(const AbuseIpDbApi::BulkReportEntry&)>;
+
+        public: // +++ Constants +++
+            const static size_t MAX_COMMENT_LENGTH; //!< 1024
+            const static string COMMENT_SEPARATOR; //!< "; "
+
+        public: // +++ Constructor / Destructor +++
+            ReportAggregator(const milliseconds window, ReportCallback callback): m_window(window), m_callback(callback) {}
+            ReportAggregator(const ReportAggregator&) = delete;
+            virtual ~ReportAggregator() { flush(); }
+
+        public: // +++ Aggregation +++
+            void            add(const string& ipAddress, const AbuseIpDbApi::ReportCategories categories, const string& comment = "",
+                                const steady_clock::time_point now = steady_clock::now()); //!< Adds a report to the window of its IP
+            size_t          poll(const steady_clock::time_point now = steady_clock::now()); //!< Emits all reports whose window has elapsed
+            size_t          flush(); //!< Emits all pending reports, regardless of their window
+
+        public: // +++ Getter +++
+            milliseconds    getTimeUntilNextReport(const steady_clock::time_point now = steady_clock::now()) const;
+            size_t          getPendingCount() const;
+
+        private: // +++ Private API +++
+            size_t          emitUntil(const steady_clock::time_point deadline);
+
+        private: // +++ Types +++
+            struct Aggregate {
+                AbuseIpDbApi::BulkReportEntry   report;     //!< The merged report
+                size_t                          mergedCount;//!< The amount of reports merged
+                unordered_set<string>           comments;   //!< The distinct comments merged so far
+            };
+
+        private: // +++ Member Variables +++
+            deque<std::pair<steady_clock::time_point, string>> m_deadlines; //!< Ordered by deadline, as the window is constant
+
+            milliseconds                        m_window;
+
+            mutable mutex                       m_mutex;
+
+            ReportCallback                      m_callback;
+
+            unordered_map<string, Aggregate>    m_aggregates;
+    };
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTAGGREGATOR_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file ReportJournal.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the declaration of a crash-safe, persistent queue for outgoing reports.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTJOURNAL_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTJOURNAL_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// spdlog
+#include <spdlog/spdlog.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/AbuseIpDbApi.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using api::AbuseIpDbApi;
+
+    using spdlog::logger;
+
+    using std::atomic_bool;
+    using std::chrono::milliseconds;
+    using std::condition_variable;
+    using std::map;
+    using std::mutex;
+    using std::pair;
+    using std::shared_mutex;
+    using std::shared_ptr;
+    using std::string;
+    using std::thread;
+    using std::vector;
+
+    /**
+     * @brief An append-only, memory-mapped write-ahead log for outgoing reports.
+     * 
+     * Reports are appended to the mapped file without any I/O on the calling thread; a background thread
+     * syncs all records written since the last sync in one go (group commit).
+     * Records which haven't been acknowledged are returned by getPending(), which allows replaying them after a restart.
+     * Once enough records have been acknowledged, the journal is compacted by rewriting the pending records into a new file
+     * which atomically replaces the old one.
+     */
+    class ReportJournal {
+        public: // +++ Constants +++
+            const static size_t         INITIAL_CAPACITY; //!< 1MiB
+            const static size_t         COMPACTION_THRESHOLD; //!< Minimum amount of acknowledged bytes before compacting
+            const static milliseconds   DEFAULT_SYNC_INTERVAL; //!< 10ms
+
+        public: // +++ Constructor / Destructor +++
+            ReportJournal(const string& path, shared_ptr<logger> logger, const milliseconds syncInterval = DEFAULT_SYNC_INTERVAL);
+            ReportJournal(const ReportJournal&) = delete;
+            virtual ~ReportJournal();
+
+        public: // +++ Journal Management +++
+            uint64_t    enqueue(const AbuseIpDbApi::BulkReportEntry& report); //!< Appends a report; returns its sequence number
+            bool        acknowledge(const uint64_t sequence); //!< Marks a report as sent
+
+            void        compact(); //!< Rewrites the journal without acknowledged records
+            void        sync(); //!< Syncs all pending changes to disk
+
+        public: // +++ Getter +++
+            vector<pair<uint64_t, AbuseIpDbApi::BulkReportEntry>> getPending() const; //!< Gets all unacknowledged reports, in order
+
+            size_t      getPendingCount() const;
+            string      getPath() const { return m_path; }
+
+        private: // +++ Private API +++
+            void        openJournal(const string& path);
+            void        closeJournal();
+            void        replay();
+            void        grow(const size_t recordSize);
+            void        runSyncThread();
+            void        syncMapping();
+
+            bool        needsCompaction() const;
+
+        private: // +++ Member Variables +++
+            atomic_bool                 m_isDirty;
+            atomic_bool                 m_isRunning;
+
+            condition_variable          m_syncCondition;
+
+            int32_t                     m_fd;
+
+            map<uint64_t, size_t>       m_pending; //!< Sequence -> offset of all unacknowledged records
+
+            milliseconds                m_syncInterval;
+
+            mutable mutex               m_mutex; //!< Protects the write offset, sequence and index
+            mutable shared_mutex        m_mapMutex; //!< Protects the mapping itself
+            mutex                       m_compactMutex; //!< Serialises compactions; syncs wait for a compaction to complete
+            mutex                       m_syncMutex;
+
+            shared_ptr<logger>          m_logger;
+
+            size_t                      m_acknowledgedBytes;
+            size_t                      m_capacity;
+            size_t                      m_writeOffset;
+
+            string                      m_path;
+
+            thread                      m_syncThread;
+
+            uint64_t                    m_nextSequence;
+
+            uint8_t*                    m_mapping;
+    };
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_REPORTING_REPORTJOURNAL_HPP
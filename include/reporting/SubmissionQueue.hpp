@@ -0,0 +1,125 @@
+/**
+ * @file SubmissionQueue.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the declaration of the queue between detectors and the API client.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_REPORTING_SUBMISSIONQUEUE_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_REPORTING_SUBMISSIONQUEUE_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+// json
+#include <nlohmann/json.hpp>
+
+// spdlog
+#include <spdlog/spdlog.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/AbuseIpDbApi.hpp"
+#include "util/BoundedQueue.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using api::AbuseIpDbApi;
+
+    using nlohmann::json;
+
+    using spdlog::logger;
+
+    using std::atomic;
+    using std::atomic_bool;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+    using std::function;
+    using std::shared_ptr;
+    using std::string;
+    using std::thread;
+
+    /**
+     * @brief A single request submitted to the queue.
+     */
+    struct Submission {
+        enum class Type: uint8_t { Report, Check };
+
+        Type                            type;           //!< Whether to report or check the IP
+        AbuseIpDbApi::BulkReportEntry   report;         //!< The report; only the IP address is used for checks
+        function<void(const json&)>     callback;       //!< Invoked on the consumer thread with the response (optional)
+        steady_clock::time_point        submittedAt;    //!< The time the submission was pushed
+
+        Submission(): type(Type::Report), report("", static_cast<AbuseIpDbApi::ReportCategories>(0)), callback(nullptr), submittedAt() {}
+        Submission(const Type t, const AbuseIpDbApi::BulkReportEntry& r, function<void(const json&)> cb = nullptr):
+            type(t), report(r), callback(cb), submittedAt(steady_clock::now()) {}
+    };
+
+    /**
+     * @brief A bounded, lock-free queue in front of the API client.
+     * 
+     * Any amount of threads may submit reports and checks; a single consumer thread owns the client and
+     * performs the requests, so producers never wait for HTTP.
+     * When the queue is full, producers either fail immediately (tryPush) or back off until a timeout elapses (push);
+     * every submission which could not be queued is counted as dropped.
+     */
+    class SubmissionQueue {
+        public: // +++ Constants +++
+            const static size_t DEFAULT_CAPACITY; //!< 4096
+
+        public: // +++ Constructor / Destructor +++
+            SubmissionQueue(shared_ptr<AbuseIpDbApi> api, shared_ptr<logger> logger, const size_t capacity = DEFAULT_CAPACITY);
+            SubmissionQueue(const SubmissionQueue&) = delete;
+            virtual ~SubmissionQueue() { stop(); }
+
+        public: // +++ Submission +++
+            bool    tryPush(Submission&& submission); //!< Queues a submission without blocking
+            bool    push(Submission&& submission, const milliseconds timeout); //!< Queues a submission, waiting up to timeout for room
+
+        public: // +++ Consumer +++
+            void    start();
+            void    stop(); //!< Stops the consumer after draining the queue
+
+        public: // +++ Getter +++
+            size_t  getDroppedCount() const { return m_droppedCount; }
+            size_t  getProcessedCount() const { return m_processedCount; }
+            size_t  getSubmittedCount() const { return m_submittedCount; }
+            size_t  size() const { return m_queue.size(); }
+
+        private: // +++ Private API +++
+            void    notifyConsumer();
+            void    process(Submission& submission);
+            void    runConsumer();
+
+        private: // +++ Member Variables +++
+            atomic<uint32_t>                m_signal; //!< Incremented whenever the consumer needs to wake up
+
+            atomic<size_t>                  m_droppedCount;
+            atomic<size_t>                  m_processedCount;
+            atomic<size_t>                  m_submittedCount;
+
+            atomic_bool                     m_isRunning;
+
+            shared_ptr<AbuseIpDbApi>        m_api;
+            shared_ptr<logger>              m_logger;
+
+            thread                          m_consumer;
+
+            utils::BoundedQueue<Submission> m_queue;
+    };
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_REPORTING_SUBMISSIONQUEUE_HPP
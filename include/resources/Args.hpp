@@ -31,13 +31,14 @@ namespace abuseipdb_client { namespace resources {
             { "--config",           required_argument,  nullptr, 'c'   },
             { "--daemon",           no_argument,        nullptr, 'd'   },
             { "--api-key",          required_argument,  nullptr, 'a'   },
+            { "--trace",            required_argument,  nullptr, 't'   },
             { nullptr,              no_argument,        nullptr, 0     }
         };
 
         return args;
     }
 
-    constexpr inline string_view getApplicationArgsString() { return R"(vhdc:a:d)"; }
+    constexpr inline string_view getApplicationArgsString() { return R"(vhdc:a:dt:)"; }
 
     inline string getHelpText(const string& argv0) {
         return fmt::format(R"(
@@ -55,6 +56,7 @@ Switches:
 Arguments:
     --config,   -c <config_path>    Override the default config path ({2:s})
     --api-key,  -a <api_key>        Override the API key (provided by config)
+    --trace,    -t <trace_path>     Write a Chrome trace of requests to <trace_path> (requires -Dabuseipdb_TRACING=ON)
 
 )", argv0, applicationVersion(), ConfigManager::DEFAULT_CONFIG_LOCATION);
     }
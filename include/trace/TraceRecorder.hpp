@@ -0,0 +1,184 @@
+/**
+ * @file TraceRecorder.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a low-overhead span recorder which writes Chrome trace JSON (viewable in Perfetto or chrome://tracing).
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_CLIENT_INCLUDE_TRACE_TRACERECORDER_HPP
+#define ABUSEIPDB_CLIENT_INCLUDE_TRACE_TRACERECORDER_HPP
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C
+#include <sys/types.h>
+
+namespace abuseipdb_client { namespace trace {
+
+    using std::atomic;
+    using std::chrono::milliseconds;
+    using std::chrono::steady_clock;
+    using std::condition_variable;
+    using std::mutex;
+    using std::shared_ptr;
+    using std::string;
+    using std::thread;
+    using std::vector;
+
+    /**
+     * @brief A single recorded span.
+     *
+     * Names and categories are not copied; they must be string literals which need no JSON escaping.
+     */
+    struct TraceEvent {
+        const char*     name;       //!< The name of the span
+        const char*     category;   //!< The category of the span (api, curl, config, queue, ...)
+        uint64_t        start;      //!< The start of the span in nanoseconds (steady clock)
+        uint64_t        duration;   //!< The duration of the span in nanoseconds
+        uint64_t        asyncId;    //!< 0 for spans on the recording thread; otherwise the span is written as an async pair
+    };
+
+    /**
+     * @brief Records spans into per-thread ring buffers and writes them to a Chrome trace file in the background.
+     *
+     * Recording a span never locks or allocates (apart from creating the buffer of a thread on its first span);
+     * if a buffer is full because the flusher fell behind, the span is dropped and counted.
+     * Recording is a no-op while the recorder is stopped.
+     *
+     * Use the ABUSEIPDB_TRACE_* macros rather than this class directly, so the spans are compiled out
+     * unless the project is configured with -Dabuseipdb_TRACING=ON.
+     */
+    class TraceRecorder {
+        public: // +++ Constants +++
+            const static size_t BUFFER_CAPACITY; //!< 8192 events per thread
+
+        public: // +++ Singleton +++
+            static TraceRecorder& getInstance() {
+                static TraceRecorder instance;
+                return instance;
+            }
+
+        public: // +++ Constructor / Destructor +++
+            TraceRecorder(const TraceRecorder&) = delete;
+            virtual ~TraceRecorder() { stop(); }
+
+        public: // +++ Recording +++
+            bool            isEnabled() const { return m_isEnabled.load(std::memory_order_relaxed); }
+
+            void            record(const TraceEvent& event);
+            void            recordAsync(const char* name, const char* category, const steady_clock::time_point start); //!< Records a span which started elsewhere (e.g. on another thread) and ends now
+
+            static uint64_t getTimestamp() { return getTimestamp(steady_clock::now()); }
+            static uint64_t getTimestamp(const steady_clock::time_point timePoint) {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch()).count();
+            }
+
+        public: // +++ Output +++
+            bool            start(const string& path, const milliseconds flushInterval = milliseconds(500));
+            void            stop();
+
+            size_t          getDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+        private: // +++ Types +++
+            /**
+             * @brief A single-producer, single-consumer ring buffer owned by one thread.
+             */
+            struct ThreadBuffer {
+                vector<TraceEvent>  events;
+
+                alignas(64) atomic<uint64_t> head;  //!< Written by the owning thread
+                uint64_t            cachedTail;     //!< The last tail seen by the owning thread; only reloaded when the buffer seems full
+
+                alignas(64) atomic<uint64_t> tail;  //!< Written by the flusher
+                pid_t               threadId;
+                string              threadName;
+                bool                isNameWritten;  //!< Whether the thread name was written to the current file; flusher only
+
+                ThreadBuffer();
+            };
+
+        private: // +++ Constructor +++
+            TraceRecorder();
+
+        private: // +++ Private API +++
+            ThreadBuffer&   getThreadBuffer();
+
+            void            flush();
+            void            runFlusher(const milliseconds flushInterval);
+
+        private: // +++ Member Variables +++
+            atomic<bool>                    m_isEnabled;
+            atomic<size_t>                  m_droppedCount;
+            atomic<uint64_t>                m_nextAsyncId;
+
+            bool                            m_stopFlusher;
+
+            condition_variable              m_flushCondition;
+
+            int32_t                         m_fd;
+
+            mutex                           m_bufferMutex;
+            mutex                           m_flushMutex;
+
+            pid_t                           m_processId;
+
+            thread                          m_flusher;
+
+            vector<shared_ptr<ThreadBuffer>> m_buffers;
+    };
+
+    /**
+     * @brief Records a span from its construction until its destruction.
+     */
+    class Span {
+        public: // +++ Constructor / Destructor +++
+            Span(const char* name, const char* category):
+                m_name(name), m_category(category),
+                m_start(TraceRecorder::getInstance().isEnabled() ? TraceRecorder::getTimestamp() : 0) {}
+            Span(const Span&) = delete;
+            ~Span() {
+                if (m_start) {
+                    TraceRecorder::getInstance().record({ m_name, m_category, m_start, TraceRecorder::getTimestamp() - m_start, 0 });
+                }
+            }
+
+        private: // +++ Member Variables +++
+            const char*     m_name;
+            const char*     m_category;
+
+            uint64_t        m_start;
+    };
+
+} /* namespace trace */ } /* namespace abuseipdb_client */
+
+#ifdef abuseipdb_TRACING
+    #define ABUSEIPDB_TRACE_CONCAT_INNER(a, b) a##b
+    #define ABUSEIPDB_TRACE_CONCAT(a, b) ABUSEIPDB_TRACE_CONCAT_INNER(a, b)
+
+    //! Records a span until the end of the enclosing scope
+    #define ABUSEIPDB_TRACE_SPAN(name, category) \
+        ::abuseipdb_client::trace::Span ABUSEIPDB_TRACE_CONCAT(abuseipdb_traceSpan_, __COUNTER__)(name, category)
+    //! Records a span from a steady_clock::time_point until now, as an async span
+    #define ABUSEIPDB_TRACE_ASYNC(name, category, start) \
+        ::abuseipdb_client::trace::TraceRecorder::getInstance().recordAsync(name, category, start)
+#else
+    #define ABUSEIPDB_TRACE_SPAN(name, category) do {} while (false)
+    #define ABUSEIPDB_TRACE_ASYNC(name, category, start) do {} while (false)
+#endif // abuseipdb_TRACING
+
+#endif // ABUSEIPDB_CLIENT_INCLUDE_TRACE_TRACERECORDER_HPP
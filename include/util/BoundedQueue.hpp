@@ -0,0 +1,149 @@
+/**
+ * @file BoundedQueue.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a bounded, lock-free multi-producer/multi-consumer queue.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_INCLUDE_UTIL_BOUNDEDQUEUE_HPP
+#define ABUSEIPDB_INCLUDE_UTIL_BOUNDEDQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace abuseipdb_client { namespace utils {
+
+    using std::atomic;
+    using std::unique_ptr;
+
+    /**
+     * @brief A bounded, array-based queue which never blocks.
+     * 
+     * Each cell carries a sequence number which tells producers and consumers whether the cell is free for them,
+     * so pushing and popping only require a single CAS on the respective position in the common case.
+     * (See Dmitry Vyukov's bounded MPMC queue.)
+     * 
+     * @tparam T The type of the elements. Must be default-constructible and move-assignable.
+     */
+    template<typename T>
+    class BoundedQueue {
+        public: // +++ Constructor / Destructor +++
+            /**
+             * @brief Constructs a new BoundedQueue.
+             * 
+             * @param capacity The capacity of the queue. Rounded up to the next power of two.
+             */
+            explicit BoundedQueue(const size_t capacity): m_cells(nullptr), m_mask(0), m_enqueuePos(0), m_dequeuePos(0) {
+                size_t actualCapacity = 2;
+                while (actualCapacity < capacity) { actualCapacity <<= 1; }
+
+                m_cells.reset(new Cell[actualCapacity]);
+                m_mask = actualCapacity - 1;
+
+                for (size_t i = 0; i < actualCapacity; i++) { m_cells[i].sequence.store(i, std::memory_order_relaxed); }
+            }
+            BoundedQueue(const BoundedQueue&) = delete;
+            ~BoundedQueue() {}
+
+        public: // +++ Queue Management +++
+            /**
+             * @brief Pushes a value to the queue, if there is room.
+             * 
+             * @param value The value to push. Is only moved from if the push succeeded.
+             * 
+             * @return true If the value was pushed.
+             * @return false If the queue is full.
+             */
+            bool tryPush(T&& value) {
+                Cell* cell = nullptr;
+                size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+                while (true) {
+                    cell = &m_cells[pos & m_mask];
+                    const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                    if (diff == 0) {
+                        if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+                    } else if (diff < 0) {
+                        return false; // full
+                    } else {
+                        pos = m_enqueuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                cell->value = std::move(value);
+                cell->sequence.store(pos + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            /**
+             * @brief Pops the oldest value from the queue, if there is one.
+             * 
+             * @param value The output value.
+             * 
+             * @return true If a value was popped.
+             * @return false If the queue is empty.
+             */
+            bool tryPop(T& value) {
+                Cell* cell = nullptr;
+                size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+                while (true) {
+                    cell = &m_cells[pos & m_mask];
+                    const auto sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+                    if (diff == 0) {
+                        if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+                    } else if (diff < 0) {
+                        return false; // empty
+                    } else {
+                        pos = m_dequeuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                value = std::move(cell->value);
+                cell->value = T{};
+                cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+                return true;
+            }
+
+        public: // +++ Getter +++
+            size_t  capacity() const { return m_mask + 1; }
+
+            /**
+             * @brief Gets the approximate amount of elements in the queue. Only exact if no other thread modifies the queue.
+             */
+            size_t  size() const {
+                const auto enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+                const auto dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+
+                return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+            }
+
+        private: // +++ Types +++
+            struct alignas(64) Cell {
+                atomic<size_t>  sequence;
+                T               value;
+            };
+
+        private: // +++ Member Variables +++
+            unique_ptr<Cell[]>              m_cells;
+
+            size_t                          m_mask;
+
+            alignas(64) atomic<size_t>      m_enqueuePos;
+            alignas(64) atomic<size_t>      m_dequeuePos;
+    };
+
+} /* namespace utils */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_INCLUDE_UTIL_BOUNDEDQUEUE_HPP
@@ -0,0 +1,159 @@
+/**
+ * @file FileBuffer.hpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains a read-only buffer holding the contents of a file, either read in a single call or memory-mapped.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+#ifndef ABUSEIPDB_INCLUDE_UTIL_FILEBUFFER_HPP
+#define ABUSEIPDB_INCLUDE_UTIL_FILEBUFFER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace abuseipdb_client { namespace utils {
+
+    namespace fs = std::filesystem;
+
+    using std::error_code;
+    using std::string;
+    using std::string_view;
+
+    /**
+     * @brief Reads the remainder of an open file descriptor and appends it to a string.
+     * 
+     * The string is grown by the expected size up front, so regular files are read with a single syscall;
+     * files which don't report their size (pipes, procfs) are read in chunks until EOF.
+     * 
+     * @param fd The file descriptor.
+     * @param expectedSize The expected no. of bytes, e.g. from fstat.
+     * @param data The string to append to.
+     * 
+     * @return true If the file was read until EOF.
+     */
+    inline bool readAll(const int fd, const size_t expectedSize, string& data) {
+        const static size_t CHUNK_SIZE = 64 * 1024;
+
+        auto length = data.size();
+        data.resize(length + (expectedSize > 0 ? expectedSize + 1 : CHUNK_SIZE)); // +1 to detect EOF without a further resize
+
+        while (true) {
+            if (length == data.size()) { data.resize(data.size() + CHUNK_SIZE); }
+
+            const auto bytesRead = ::read(fd, data.data() + length, data.size() - length);
+            if (bytesRead < 0 && errno == EINTR) { continue; }
+            if (bytesRead < 0) {
+                data.resize(length);
+                return false;
+            }
+            if (bytesRead == 0) { break; }
+
+            length += bytesRead;
+        }
+
+        data.resize(length);
+        return true;
+    }
+
+    /**
+     * @brief A read-only view of a file's contents.
+     * 
+     * Small files are read into memory with a single read; files of at least MMAP_THRESHOLD bytes are mapped,
+     * so large IP lists and bulk-report inputs are paged in on demand and never copied.
+     * 
+     * A mapped file must not be truncated while the buffer is alive: reading a page past the new end of the file
+     * raises SIGBUS. Pass allowMapping = false for files which other processes may rewrite in place
+     * (files which are replaced by renaming are safe, as the mapping keeps the old inode).
+     */
+    class FileBuffer {
+        public: // +++ Constants +++
+            inline static constexpr size_t MMAP_THRESHOLD = 1024 * 1024; //!< 1MiB
+
+        public: // +++ Constructor / Destructor +++
+            /**
+             * @brief Loads a file.
+             * 
+             * @param path The path to the file.
+             * @param allowMapping Whether large files may be mapped; if false, the file is always read into memory.
+             * 
+             * @throws fs::filesystem_error If the file cannot be opened or read.
+             */
+            explicit FileBuffer(const string& path, const bool allowMapping = true): m_mapping(nullptr), m_size(0), m_data() {
+                const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) { throwFileError("Failed to open file", path, errno); }
+
+                struct stat fileStat{};
+                if (fstat(fd, &fileStat) != 0) {
+                    const auto error = errno; // close() may overwrite it
+                    ::close(fd);
+                    throwFileError("Failed to stat file", path, error);
+                }
+
+                const auto fileSize = static_cast<size_t>(fileStat.st_size);
+
+                if (allowMapping && S_ISREG(fileStat.st_mode) && fileSize >= MMAP_THRESHOLD) {
+                    auto* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (mapping != MAP_FAILED) {
+                        madvise(mapping, fileSize, MADV_SEQUENTIAL);
+                        ::close(fd);
+
+                        m_mapping = static_cast<const char*>(mapping);
+                        m_size = fileSize;
+                        return;
+                    }
+                }
+
+                const auto isRead = readAll(fd, fileSize, m_data);
+                const auto error = errno;
+                ::close(fd);
+                if (!isRead) { throwFileError("Failed to read file", path, error); }
+
+                m_size = m_data.size();
+            }
+            FileBuffer(FileBuffer&& other) noexcept: m_mapping(other.m_mapping), m_size(other.m_size), m_data(std::move(other.m_data)) {
+                other.m_mapping = nullptr;
+                other.m_size = 0;
+            }
+            FileBuffer(const FileBuffer&) = delete;
+            ~FileBuffer() {
+                if (m_mapping) { munmap(const_cast<char*>(m_mapping), m_size); }
+            }
+
+        public: // +++ Getter +++
+            const char* data() const { return m_mapping ? m_mapping : m_data.data(); }
+
+            size_t      size() const { return m_size; }
+
+            bool        isMapped() const { return m_mapping != nullptr; }
+
+            string_view view() const { return string_view(data(), m_size); }
+
+        private: // +++ Private API +++
+            [[noreturn]] static void throwFileError(const string& message, const string& path, const int error) {
+                throw fs::filesystem_error(message, fs::path(path), error_code(error, std::system_category()));
+            }
+
+        private: // +++ Member Variables +++
+            const char* m_mapping;
+
+            size_t      m_size;
+
+            string      m_data;
+    };
+
+} /* namespace utils */ } /* namespace abuseipdb_client */
+
+#endif // ABUSEIPDB_INCLUDE_UTIL_FILEBUFFER_HPP
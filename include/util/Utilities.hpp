@@ -11,48 +11,80 @@
 #ifndef ABUSEIPDB_INCLUDE_UTIL_UTILITIES_HPP
 #define ABUSEIPDB_INCLUDE_UTIL_UTILITIES_HPP
 
-#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <iterator>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/FileBuffer.hpp"
+
 namespace abuseipdb_client { namespace utils {
 
-    using std::ifstream;
     using std::regex;
     using std::string;
+    using std::string_view;
+    using std::unordered_map;
     using std::vector;
 
     namespace reg = std::regex_constants;
 
+    /**
+     * @brief Reads a file and appends its contents to a string.
+     * 
+     * The buffer is sized from fstat, so the file is read with a single syscall. Use FileBuffer for large files.
+     * 
+     * @param path The path to the file.
+     * @param data The string to append to.
+     * 
+     * @return true If the file was read completely.
+     */
     inline bool readFile(const string& path, string &data) {
-        string line;
-        ifstream fileInput(path.c_str());
-        int peekChar;
-        bool returnVal = true;
-        if (fileInput.is_open()) {
-            while ((peekChar = fileInput.peek()) != EOF) {
-                if (getline(fileInput, line, '\n')) {
-                    data.append(line);
-                    data.append("\n");
-                } else {
-                    // Getline failed. Find out what the error was
-                    if (fileInput.bad() || fileInput.fail()) {
-                        returnVal = false;
-                    } else {
-                        returnVal = true;
-                    }
-                }
-            }
-            fileInput.close();
-        } else { returnVal = false; }
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { return false; }
+
+        struct stat fileStat{};
+        const auto returnVal = fstat(fd, &fileStat) == 0 && readAll(fd, fileStat.st_size, data);
+        ::close(fd);
 
         return returnVal;
     }
 
+    /**
+     * @brief Gets the compiled form of a regular expression.
+     * 
+     * Each pattern is compiled once per thread; the cache is thread-local, so lookups don't need to lock.
+     * 
+     * @param pattern The regular expression.
+     * 
+     * @return const regex& The compiled expression. Remains valid for the lifetime of the calling thread.
+     */
+    inline const regex& getCompiledRegex(const string& pattern) {
+        thread_local unordered_map<string, regex> compiledPatterns{};
+
+        auto pos = compiledPatterns.find(pattern);
+        if (pos == compiledPatterns.end()) {
+            pos = compiledPatterns.emplace(pattern, regex(pattern)).first;
+        }
+
+        return pos->second;
+    }
+
+    inline bool regexMatch(const string_view haystack, const regex& pattern) {
+        return std::regex_match(haystack.begin(), haystack.end(), pattern);
+    }
+
     inline bool regexMatch(const string& haystack, const string& pattern) {
-        const regex regPattern(pattern);
-        return std::regex_match(haystack, regPattern);
+        return regexMatch(string_view(haystack), getCompiledRegex(pattern));
     }
 
     inline bool splitString(const string& str, const string& delimiters, vector<string>& tokens, size_t maxLen = SIZE_MAX) {
@@ -61,11 +93,11 @@ namespace abuseipdb_client { namespace utils {
         // Find first "non-delimiter".
         size_t pos = str.find_first_of(delimiters, lastPos);
 
-        while ((string::npos != pos || string::npos != lastPos) && maxLen < tokens.size()) {
+        while (string::npos != lastPos && tokens.size() < maxLen) {
             // Found a token, add it to the vector.
             tokens.push_back(str.substr(lastPos, pos - lastPos));
             // Skip delimiters.
-            lastPos = string::npos == pos ? string::npos : pos + 1;
+            lastPos = str.find_first_not_of(delimiters, pos);
             // Find next "non-delimiter"
             pos = str.find_first_of(delimiters, lastPos);
         }
@@ -81,18 +113,226 @@ namespace abuseipdb_client { namespace utils {
         return tokens;
     }
 
-    inline string replaceString(string& haystack, const string& needle, const string& replacement, const int32_t maxCount = -1) {
-        size_t needleLocation = 0;
-        int32_t currentCount = 0;
+    /**
+     * @brief A lazily evaluated split of a string, yielding views onto the original string.
+     * 
+     * Behaves like splitString (consecutive delimiters are collapsed, empty tokens are skipped), but doesn't allocate.
+     * The split string must outlive the view and its tokens.
+     */
+    class SplitView {
+        public: // +++ Iterator +++
+            class Iterator {
+                public: // +++ Types +++
+                    using iterator_category = std::forward_iterator_tag;
+                    using value_type        = string_view;
+                    using difference_type   = std::ptrdiff_t;
+                    using pointer           = const string_view*;
+                    using reference         = const string_view&;
+
+                public: // +++ Constructor +++
+                    Iterator(): m_str(), m_delimiters(), m_token(), m_tokenStart(string_view::npos) {}
+                    Iterator(const string_view str, const string_view delimiters):
+                    m_str(str), m_delimiters(delimiters), m_token(), m_tokenStart(0) { findToken(0); }
+
+                public: // +++ Operators +++
+                    reference   operator*() const { return m_token; }
+                    pointer     operator->() const { return &m_token; }
+
+                    Iterator&   operator++() { findToken(m_tokenStart + m_token.size()); return *this; }
+                    Iterator    operator++(int) { auto copy = *this; ++*this; return copy; }
+
+                    bool        operator==(const Iterator& other) const { return m_tokenStart == other.m_tokenStart; }
+                    bool        operator!=(const Iterator& other) const { return !(*this == other); }
+
+                private: // +++ Private API +++
+                    void findToken(const size_t from) {
+                        m_tokenStart = m_str.find_first_not_of(m_delimiters, from);
+                        if (m_tokenStart == string_view::npos) {
+                            m_token = string_view();
+                            return;
+                        }
+
+                        const auto tokenEnd = m_str.find_first_of(m_delimiters, m_tokenStart);
+                        m_token = m_str.substr(m_tokenStart, tokenEnd == string_view::npos ? string_view::npos : tokenEnd - m_tokenStart);
+                    }
+
+                private: // +++ Member Variables +++
+                    string_view m_str;
+                    string_view m_delimiters;
+                    string_view m_token;
+
+                    size_t      m_tokenStart; //!< npos for the end iterator
+            };
+
+        public: // +++ Constructor +++
+            SplitView(const string_view str, const string_view delimiters): m_str(str), m_delimiters(delimiters) {}
+
+        public: // +++ Range +++
+            Iterator    begin() const { return Iterator(m_str, m_delimiters); }
+            Iterator    end() const { return Iterator(); }
+
+        private: // +++ Member Variables +++
+            string_view m_str;
+            string_view m_delimiters;
+    };
+
+    /**
+     * @brief Splits a string into views onto the original string, without allocating.
+     * 
+     * @param str The string to split. Must outlive the returned view.
+     * @param delimiters Each character is a delimiter.
+     */
+    inline SplitView splitView(const string_view str, const string_view delimiters) { return SplitView(str, delimiters); }
+
+    /**
+     * @brief Replaces occurrences of a string within a string, in place.
+     * 
+     * The string is traversed once and resized at most once; replacements are never searched again.
+     * 
+     * @param haystack The string to modify.
+     * @param needle The string to replace. Must not be empty.
+     * @param replacement The replacement.
+     * @param maxCount The max. no. of replacements; negative values replace all occurrences.
+     * 
+     * @return size_t The no. of replacements made.
+     */
+    inline size_t replaceInPlace(string& haystack, const string_view needle, const string_view replacement, const int32_t maxCount = -1) {
+        if (needle.empty() || maxCount == 0) { return 0; }
+
+        const auto maxReplacements = maxCount < 0 ? SIZE_MAX : static_cast<size_t>(maxCount);
+
+        if (needle.size() >= replacement.size()) {
+            // the string shrinks (or keeps its size): compact it front to back
+            size_t readPos = 0;
+            size_t writePos = 0;
+            size_t count = 0;
+
+            for (size_t pos = haystack.find(needle); pos != string::npos && count < maxReplacements; pos = haystack.find(needle, readPos)) {
+                std::copy(haystack.begin() + readPos, haystack.begin() + pos, haystack.begin() + writePos);
+                writePos += pos - readPos;
+
+                std::copy(replacement.begin(), replacement.end(), haystack.begin() + writePos);
+                writePos += replacement.size();
+                readPos = pos + needle.size();
+                count++;
+            }
 
-        while ((needleLocation = haystack.find(needle)) != string::npos) {
-            haystack.replace(needleLocation, needle.size(), replacement);
-            if (currentCount++ >= maxCount) { break; }
+            if (writePos != readPos) {
+                std::copy(haystack.begin() + readPos, haystack.end(), haystack.begin() + writePos);
+                haystack.resize(writePos + haystack.size() - readPos);
+            }
+
+            return count;
+        }
+
+        // the string grows: count the occurrences, resize once, then fill back to front
+        vector<size_t> positions{};
+        for (size_t pos = haystack.find(needle); pos != string::npos && positions.size() < maxReplacements; pos = haystack.find(needle, pos + needle.size())) {
+            positions.push_back(pos);
+        }
+
+        if (positions.empty()) { return 0; }
+
+        const auto oldSize = haystack.size();
+        haystack.resize(oldSize + positions.size() * (replacement.size() - needle.size()));
+
+        auto readEnd = oldSize;
+        auto writeEnd = haystack.size();
+        for (auto pos = positions.rbegin(); pos != positions.rend(); pos++) {
+            const auto tailStart = *pos + needle.size();
+            const auto tailLength = readEnd - tailStart;
+
+            std::copy_backward(haystack.begin() + tailStart, haystack.begin() + readEnd, haystack.begin() + writeEnd);
+            writeEnd -= tailLength;
+
+            std::copy(replacement.begin(), replacement.end(), haystack.begin() + writeEnd - replacement.size());
+            writeEnd -= replacement.size();
+            readEnd = *pos;
         }
 
+        return positions.size();
+    }
+
+    inline string replaceString(string& haystack, const string& needle, const string& replacement, const int32_t maxCount = -1) {
+        replaceInPlace(haystack, needle, replacement, maxCount);
+
         return haystack;
     }
 
+    /**
+     * @brief Parses an ISO 8601 timestamp as returned by AbuseIPDB (e.g. 2018-12-20T20:55:14+00:00) to a UNIX timestamp.
+     * 
+     * @param timestamp The timestamp. The offset may be omitted, or given as Z or (+|-)HH:MM.
+     * @param output The parsed timestamp in UTC.
+     * 
+     * @return true If the timestamp could be parsed.
+     */
+    inline bool parseTimestamp(const string_view timestamp, time_t& output) {
+        const auto getNumber = [&](const size_t pos, const size_t len, int32_t& value) {
+            value = 0;
+            if (pos + len > timestamp.size()) { return false; }
+            for (size_t i = pos; i < pos + len; i++) {
+                if (timestamp[i] < '0' || timestamp[i] > '9') { return false; }
+                value = value * 10 + (timestamp[i] - '0');
+            }
+            return true;
+        };
+
+        tm time{};
+        if (!getNumber(0, 4, time.tm_year) || !getNumber(5, 2, time.tm_mon) || !getNumber(8, 2, time.tm_mday) ||
+            !getNumber(11, 2, time.tm_hour) || !getNumber(14, 2, time.tm_min) || !getNumber(17, 2, time.tm_sec)) {
+            return false;
+        }
+
+        time.tm_year -= 1900;
+        time.tm_mon -= 1;
+        output = timegm(&time);
+
+        // skip fractional seconds
+        size_t pos = 19;
+        if (pos < timestamp.size() && timestamp[pos] == '.') {
+            while (++pos < timestamp.size() && timestamp[pos] >= '0' && timestamp[pos] <= '9') {}
+        }
+
+        if (pos + 6 <= timestamp.size() && (timestamp[pos] == '+' || timestamp[pos] == '-')) {
+            int32_t offsetHours = 0;
+            int32_t offsetMinutes = 0;
+            if (!getNumber(pos + 1, 2, offsetHours) || !getNumber(pos + 4, 2, offsetMinutes)) { return false; }
+
+            const auto offset = (offsetHours * 60 + offsetMinutes) * 60;
+            output += timestamp[pos] == '+' ? -offset : offset;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Parses a dotted IPv4 address.
+     * 
+     * @param address The address, e.g. 193.41.200.1
+     * @param output The address in host byte order.
+     * 
+     * @return true If the address is a valid IPv4 address.
+     */
+    inline bool parseIpv4Address(const string& address, uint32_t& output) {
+        in_addr addr{};
+        if (inet_pton(AF_INET, address.c_str(), &addr) != 1) { return false; }
+
+        output = ntohl(addr.s_addr);
+        return true;
+    }
+
+    /**
+     * @brief Formats an IPv4 address in host byte order to its dotted representation.
+     */
+    inline string formatIpv4Address(const uint32_t address) {
+        char buffer[INET_ADDRSTRLEN] = { 0 };
+        in_addr addr{ htonl(address) };
+        inet_ntop(AF_INET, &addr, buffer, sizeof(buffer));
+
+        return buffer;
+    }
+
 } /* namespace utils */ } /* namespace abuseipdb_client */
 
 #endif // ABUSEIPDB_INCLUDE_UTIL_UTILITIES_HPP
\ No newline at end of file
@@ -14,6 +14,7 @@
 // stl
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <exception>
 #include <filesystem>
 #include <fstream>
@@ -32,6 +33,7 @@
 
 // spdlog
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/syslog_sink.h>
 
@@ -41,6 +43,7 @@
 #include "api/AbuseIpDbApi.hpp"
 #include "cfg/ConfigManager.hpp"
 #include "resources/Args.hpp"
+#include "trace/TraceRecorder.hpp"
 
 using abuseipdb_client::cfg::ConfigManager;
 
@@ -69,6 +72,8 @@ using std::vector;
     const static level_enum LOG_LEVEL = level_enum::info;
 #endif // ipreporter_DEBUG
 
+const static size_t LOG_QUEUE_SIZE = 8192; //!< Messages queued for the logging thread; the oldest are dropped when full
+
 ///////////////////////
 //  GLOBAL VARIABLES //
 ///////////////////////
@@ -114,7 +119,7 @@ bool parseArgs(const int32_t argc, char** argv) {
         switch (arg) {
             case -1: break;
             case 0:
-                g_logger->debug("Got option {0:s}", getApplicationArgs()[optionIndex].name);
+                SPDLOG_LOGGER_DEBUG(g_logger, "Got option {0:s}", getApplicationArgs()[optionIndex].name);
                 break;
 
             case '?':
@@ -123,12 +128,24 @@ bool parseArgs(const int32_t argc, char** argv) {
                 break;
 
             case 'c':
-                g_logger->debug("Config file location overridden. New location: {0:s}", optarg);
+                SPDLOG_LOGGER_DEBUG(g_logger, "Config file location overridden. New location: {0:s}", optarg);
                 g_configLocation = optarg;
                 break;
 
+            case 't':
+                #ifdef abuseipdb_TRACING
+                if (!abuseipdb_client::trace::TraceRecorder::getInstance().start(optarg)) {
+                    g_logger->error("Failed to open trace file {0:s}", optarg);
+                    return false;
+                }
+                std::atexit([]() { abuseipdb_client::trace::TraceRecorder::getInstance().stop(); });
+                #else
+                g_logger->warn("Tracing is not compiled in; rebuild with -Dabuseipdb_TRACING=ON to use --trace");
+                #endif // abuseipdb_TRACING
+                break;
+
             case 'h':
-                fmt::print(getHelpText(argv[0]));
+                fmt::print("{:s}", getHelpText(argv[0]));
                 return false;
         }
 
@@ -144,8 +161,8 @@ void setupConfig() {
 void setupLogging() {
     int32_t syslogOptions = LOG_PID;
     vector<spdlog::sink_ptr> sinks = {
-        make_shared<spdlog::sinks::syslog_sink_st>("abuseipdb", syslogOptions, LOG_PID, true),
-        make_shared<spdlog::sinks::stdout_color_sink_st>(spdlog::color_mode::always)
+        make_shared<spdlog::sinks::syslog_sink_mt>("abuseipdb", syslogOptions, LOG_DAEMON, true),
+        make_shared<spdlog::sinks::stdout_color_sink_mt>(spdlog::color_mode::always)
     };
 
     // set log level for each sink
@@ -153,6 +170,15 @@ void setupLogging() {
         x->set_level(LOG_LEVEL);
         x->set_pattern("[%Y-%m-%d] [%H:%M:%S] [%^%l%$] %v");
     });
-    g_logger = make_shared<spdlog::logger>("ipdbreporter", sinks.begin(), sinks.end());
+
+    // sinks are written by a background thread, so slow sinks (syslog) never stall the threads doing the logging.
+    // if the queue fills up, the oldest messages are dropped rather than blocking.
+    spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+    g_logger = make_shared<spdlog::async_logger>(
+        "ipdbreporter", sinks.begin(), sinks.end(), spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest
+    );
     g_logger->set_level(LOG_LEVEL);
+    g_logger->flush_on(level_enum::err);
+
+    std::atexit([]() { spdlog::shutdown(); }); // write out queued messages on exit
 }
@@ -12,12 +12,22 @@
 //  SYSTEM INCLUDES  //
 ///////////////////////
 // stl
+#include <algorithm>
 #include <bitset>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
 #include <exception>
 #include <filesystem>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 // curl
@@ -33,6 +43,11 @@
 //  LOCAL  INCLUDES  //
 ///////////////////////
 #include "api/AbuseIpDbApi.hpp"
+#include "api/RateLimiter.hpp"
+#include "api/RequestTiming.hpp"
+#include "api/SubnetReport.hpp"
+#include "trace/TraceRecorder.hpp"
+#include "util/Utilities.hpp"
 
 namespace abuseipdb_client { namespace api {
 
@@ -41,7 +56,10 @@ namespace abuseipdb_client { namespace api {
     using spdlog::fmt_lib::format;
 
     using std::bitset;
+    using std::chrono::microseconds;
+    using std::chrono::milliseconds;
     using std::error_code;
+    using std::function;
     using std::make_shared;
     using std::map;
     using std::shared_ptr;
@@ -54,6 +72,36 @@ namespace abuseipdb_client { namespace api {
     const size_t AbuseIpDbApi::MAX_IPS_BASIC_SUB = 100'000;
     const size_t AbuseIpDbApi::MAX_IPS_PREMIUM_SUB = 500'000;
 
+    const size_t AbuseIpDbApi::MAX_SUBNET_STANDARD = 24;
+    const size_t AbuseIpDbApi::MAX_SUBNET_BASIC_SUB = 20;
+    const size_t AbuseIpDbApi::MAX_SUBNET_PREMIUM_SUB = 16;
+
+    const size_t AbuseIpDbApi::MAX_AGE_IN_DAYS = 365;
+
+    const size_t AbuseIpDbApi::MAX_BULK_REPORT_LINES = 10'000;
+    const size_t AbuseIpDbApi::MAX_BULK_REPORT_SIZE = 2 * 1024 * 1024;
+
+    const size_t AbuseIpDbApi::MAX_CHECK_BLOCKED_REQUESTS = 4096;
+
+    const static string BULK_REPORT_API_URL = "https://api.abuseipdb.com/api/v2/bulk-report";
+    const static string BULK_REPORT_CSV_HEADER = "IP,Categories,ReportDate,Comment\n";
+
+    const static milliseconds BULK_REPORT_RETRY_DELAY = milliseconds(1000); //!< Doubled with each follow-up batch
+    const static milliseconds MAX_BULK_REPORT_RETRY_DELAY = milliseconds(300'000); //!< 5 minutes; also caps Retry-After
+
+    /**
+     * @brief A single transfer performed by performConcurrently.
+     */
+    struct ConcurrentRequest {
+        CURL*               handle;     //!< The easy handle; configured by the caller's prepare callback
+        struct curl_slist*  headers;    //!< The headers applied to the handle
+        curl_mime*          form;       //!< The (optional) form posted by the handle
+        vector<size_t>      indices;    //!< Arbitrary indices the caller associates with this request
+        string              response;   //!< The response body
+        CURLcode            result;     //!< The result of the transfer
+        string              responseHeaders; //!< The raw response headers
+    };
+
     /**
      * @brief Escapes a string so it only contains legal URL chars.
      * 
@@ -121,6 +169,432 @@ namespace abuseipdb_client { namespace api {
         return headers;
     }
 
+    /**
+     * @brief Builds the query string of a blacklist request.
+     * 
+     * @param options The options for the blacklist.
+     * @param curl The CURL handle used for escaping.
+     * 
+     * @return string The query string, without the leading '?'.
+     */
+    static string getBlackListQuery(const AbuseIpDbApi::BlackListOptions& options, CURL* curl) {
+        const auto joinCountries = [](const vector<string>& countries) {
+            return countries.empty() ? string{} : std::accumulate(
+                std::next(countries.begin()), countries.end(), countries.front(),
+                [](string a, const string& b) { return std::move(a) + "," + b; }
+            );
+        };
+
+        auto confidenceMinimum  = "confidenceMinimum=" + getEscapedString(std::to_string(options.minimumConfidence), curl);
+        auto limit              = "limit=" + getEscapedString(std::to_string(options.limit), curl);
+        auto countryList        = options.onlyCountries.size() > 0 ?
+                                  "onlyCountries=" + getEscapedString(joinCountries(options.onlyCountries), curl)
+                                  :
+                                  "exceptCountries=" + getEscapedString(joinCountries(options.exceptCountries), curl);
+
+        return format("{:s}&{:s}&{:s}", confidenceMinimum, limit, countryList);
+    }
+
+    /**
+     * @brief Gets the value of a response header.
+     * 
+     * @param headers The raw response headers, as received by the header callback.
+     * @param name The (case-insensitive) name of the header.
+     * 
+     * @return string The value of the last occurrence of the header, or an empty string if it wasn't sent.
+     */
+    static string getResponseHeader(const string& headers, const string& name) {
+        string value{};
+
+        for (size_t lineStart = 0; lineStart < headers.size();) {
+            auto lineEnd = headers.find('\n', lineStart);
+            if (lineEnd == string::npos) { lineEnd = headers.size(); }
+
+            const auto line = std::string_view(headers).substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            if (line.size() <= name.size() || line[name.size()] != ':') { continue; }
+            if (!std::equal(name.begin(), name.end(), line.begin(), [](const char a, const char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+                continue;
+            }
+
+            const auto valueStart = line.find_first_not_of(" \t", name.size() + 1);
+            const auto valueEnd = line.find_last_not_of(" \t\r");
+            value = valueStart == string::npos ? string{} : string(line.substr(valueStart, valueEnd - valueStart + 1));
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Gets the timing breakdown of a finished transfer.
+     * 
+     * @param endpoint The name of the API endpoint.
+     * @param handle The easy handle which performed the transfer. Must not have been reset yet.
+     * @param result The result of the transfer.
+     * 
+     * @return RequestTiming The status, phase timestamps, sizes and connection reuse of the transfer.
+     */
+    static RequestTiming getRequestTiming(const string& endpoint, CURL* handle, const CURLcode result) {
+        RequestTiming timing{};
+        timing.endpoint = endpoint;
+        timing.result = result;
+
+        const auto getTime = [handle](const CURLINFO info) {
+            curl_off_t value = 0;
+            curl_easy_getinfo(handle, info, &value);
+            return microseconds(std::max<curl_off_t>(value, 0));
+        };
+        const auto getSize = [handle](const CURLINFO info) {
+            curl_off_t value = 0;
+            curl_easy_getinfo(handle, info, &value);
+            return static_cast<uint64_t>(std::max<curl_off_t>(value, 0));
+        };
+
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &timing.httpStatus);
+        curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &timing.newConnections);
+
+        timing.nameLookup = getTime(CURLINFO_NAMELOOKUP_TIME_T);
+        timing.connect = getTime(CURLINFO_CONNECT_TIME_T);
+        timing.appConnect = getTime(CURLINFO_APPCONNECT_TIME_T);
+        timing.startTransfer = getTime(CURLINFO_STARTTRANSFER_TIME_T);
+        timing.total = getTime(CURLINFO_TOTAL_TIME_T);
+
+        timing.bytesDownloaded = getSize(CURLINFO_SIZE_DOWNLOAD_T);
+        timing.bytesUploaded = getSize(CURLINFO_SIZE_UPLOAD_T);
+
+        // a transfer which failed before connecting didn't reuse anything either
+        timing.connectionReused = timing.newConnections == 0 && timing.httpStatus != 0;
+
+        return timing;
+    }
+
+    /**
+     * @brief Gets the headers which make a blacklist request conditional on the cached list having changed.
+     * 
+     * If AbuseIPDB didn't send a Last-Modified header, the generation time of the cached list is used instead.
+     * 
+     * @param eTag The ETag of the cached list.
+     * @param lastModified The Last-Modified header of the cached list.
+     * @param generatedAt The generation time of the cached list.
+     * 
+     * @return map<string, string> The additional request headers.
+     */
+    static map<string, string> getConditionalHeaders(const string& eTag, const string& lastModified, const time_t generatedAt) {
+        map<string, string> headers{};
+
+        if (!eTag.empty()) { headers["If-None-Match"] = eTag; }
+
+        if (!lastModified.empty()) {
+            headers["If-Modified-Since"] = lastModified;
+        } else if (generatedAt > 0) {
+            struct tm timeInfo{};
+            char httpDate[32]{};
+
+            gmtime_r(&generatedAt, &timeInfo);
+            strftime(httpDate, sizeof(httpDate), "%a, %d %b %Y %H:%M:%S GMT", &timeInfo);
+            headers["If-Modified-Since"] = httpDate;
+        }
+
+        return headers;
+    }
+
+    /**
+     * @brief Performs a single transfer on an easy handle.
+     * 
+     * @param handle The configured easy handle.
+     * 
+     * @return CURLcode The result of the transfer.
+     */
+    static CURLcode performTransfer(CURL* handle) {
+        ABUSEIPDB_TRACE_SPAN("curl_easy_perform", "curl");
+        return curl_easy_perform(handle);
+    }
+
+    /**
+     * @brief Performs several transfers concurrently using the curl multi interface.
+     * 
+     * Requests are only prepared once they can be started, so no more than maxConcurrent easy handles exist at once;
+     * handles are reset and reused for subsequent requests.
+     * The write and header callbacks and private pointer of each handle are set by this function.
+     * 
+     * @param requestCount The amount of requests to perform.
+     * @param maxConcurrent The maximum amount of transfers in flight at once.
+     * @param rateLimiter An optional rate limiter; a token is consumed before each transfer is started.
+     * @param prepare Configures a request; its indices contain the index of the request (0 - requestCount-1).
+     * @param complete Handles a finished request. Its headers and form are freed afterwards.
+     */
+    static void performConcurrently(const size_t requestCount, const size_t maxConcurrent, RateLimiter* rateLimiter,
+                                    const function<void(ConcurrentRequest&)>& prepare, const function<void(ConcurrentRequest&)>& complete) {
+        ABUSEIPDB_TRACE_SPAN("performConcurrently", "curl");
+        CURLM* multiHandle = curl_multi_init();
+
+        const auto concurrencyLimit = std::max<size_t>(maxConcurrent, 1);
+        vector<ConcurrentRequest> requests(std::min(concurrencyLimit, requestCount)); // never reallocated; handles point into it
+        vector<ConcurrentRequest*> idleRequests{};
+        for (auto& request : requests) { idleRequests.push_back(&request); }
+
+        size_t nextRequest = 0;
+        size_t activeRequests = 0;
+        int32_t runningHandles = 0;
+
+        do {
+            int32_t timeoutMs = 100;
+
+            while (!idleRequests.empty() && nextRequest < requestCount) {
+                if (rateLimiter && !rateLimiter->tryAcquire()) {
+                    timeoutMs = std::min<int32_t>(timeoutMs, rateLimiter->getWaitTime().count());
+                    break;
+                }
+
+                auto& request = *idleRequests.back();
+                idleRequests.pop_back();
+
+                if (!request.handle) { request.handle = curl_easy_init(); }
+                request.indices = { nextRequest++ };
+                prepare(request);
+
+                curl_easy_setopt(request.handle, CURLOPT_WRITEFUNCTION, handleCurlWrite);
+                curl_easy_setopt(request.handle, CURLOPT_ACCEPT_ENCODING, "");
+                curl_easy_setopt(request.handle, CURLOPT_WRITEDATA, &request.response);
+                curl_easy_setopt(request.handle, CURLOPT_HEADERFUNCTION, handleCurlWrite);
+                curl_easy_setopt(request.handle, CURLOPT_HEADERDATA, &request.responseHeaders);
+                curl_easy_setopt(request.handle, CURLOPT_PRIVATE, &request);
+                curl_multi_add_handle(multiHandle, request.handle);
+                activeRequests++;
+            }
+
+            curl_multi_perform(multiHandle, &runningHandles);
+
+            CURLMsg* message = nullptr;
+            int32_t queuedMessages = 0;
+            while ((message = curl_multi_info_read(multiHandle, &queuedMessages)) != nullptr) {
+                if (message->msg != CURLMSG_DONE) { continue; }
+
+                ConcurrentRequest* request = nullptr;
+                curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &request);
+                request->result = message->data.result;
+
+                curl_multi_remove_handle(multiHandle, message->easy_handle);
+                activeRequests--;
+
+                complete(*request);
+
+                curl_mime_free(request->form);
+                curl_slist_free_all(request->headers);
+                curl_easy_reset(request->handle);
+                *request = { request->handle, nullptr, nullptr, {}, {}, CURLcode::CURLE_OK, {} };
+                idleRequests.push_back(request);
+            }
+
+            if (activeRequests > 0 || nextRequest < requestCount) {
+                curl_multi_poll(multiHandle, nullptr, 0, std::max(timeoutMs, 1), nullptr);
+            }
+        } while (activeRequests > 0 || nextRequest < requestCount);
+
+        for (auto& request : requests) {
+            if (request.handle) { curl_easy_cleanup(request.handle); }
+        }
+
+        curl_multi_cleanup(multiHandle);
+    }
+
+    /**
+     * @brief Determines whether a row rejected by a bulk report may succeed if it is sent again.
+     * 
+     * Only transient errors (rate limits, server errors and timeouts) are retried. Anything else, in particular
+     * rows rejected because of their content or because the IP was reported too recently, will be rejected again;
+     * unknown errors are treated as permanent, so new validation messages never cause pointless resubmissions.
+     * 
+     * @param error The error message returned by AbuseIPDB.
+     * 
+     * @return true If the row should be resubmitted.
+     */
+    static bool isRetryableBulkError(const string& error) {
+        const static vector<string> TRANSIENT_ERRORS = {
+            "rate limit", "too many", "try again", "temporar", "timeout", "timed out",
+            "server error", "internal error", "unavailable", "bad gateway"
+        }; //!< Words only; status codes could match IP addresses or row numbers quoted in permanent errors
+
+        string lowerError(error);
+        std::transform(lowerError.begin(), lowerError.end(), lowerError.begin(), [](const unsigned char x) { return std::tolower(x); });
+
+        return std::any_of(TRANSIENT_ERRORS.begin(), TRANSIENT_ERRORS.end(), [&](const string& x) {
+            return lowerError.find(x) != string::npos;
+        });
+    }
+
+    /**
+     * @brief Determines whether a bulk report which wasn't answered with any data may succeed if it is sent again.
+     * 
+     * Transfer errors and unparsable responses are retried, as are rate limits (429) and server errors (5xx).
+     * Other errors (e.g. 401 or 422) will occur again.
+     * 
+     * @param response The parsed response; null if the transfer failed or the response couldn't be parsed.
+     * 
+     * @return true If the whole request should be resubmitted.
+     */
+    static bool isRetryableBulkFailure(const json& response) {
+        if (response.is_null() || !response.contains("errors") || !response.at("errors").is_array()) { return true; }
+
+        return std::any_of(response.at("errors").begin(), response.at("errors").end(), [](const json& error) {
+            const auto status = error.is_object() && error.contains("status") && error.at("status").is_number() ? error.at("status").get<int64_t>() : 0;
+            return status == 0 || status == 429 || status >= 500;
+        });
+    }
+
+    /**
+     * @brief Gets the delay before a follow-up batch of a bulk report.
+     * 
+     * The delay doubles with each attempt; a longer Retry-After sent by AbuseIPDB takes precedence.
+     * 
+     * @param responseHeaders The raw response headers of the last attempt.
+     * @param attempts The amount of requests sent so far.
+     * 
+     * @return milliseconds The delay, at most MAX_BULK_REPORT_RETRY_DELAY.
+     */
+    static milliseconds getBulkReportRetryDelay(const string& responseHeaders, const size_t attempts) {
+        auto delay = BULK_REPORT_RETRY_DELAY * (int64_t(1) << std::min<size_t>(attempts > 0 ? attempts - 1 : 0, 16));
+
+        // only the delta-seconds form is supported; AbuseIPDB doesn't send HTTP dates
+        const auto retryAfter = getResponseHeader(responseHeaders, "Retry-After");
+        if (!retryAfter.empty() && std::all_of(retryAfter.begin(), retryAfter.end(), [](const unsigned char x) { return std::isdigit(x); })) {
+            const auto retryAfterSeconds = std::min<uint64_t>(std::strtoull(retryAfter.c_str(), nullptr, 10), MAX_BULK_REPORT_RETRY_DELAY.count() / 1000);
+            delay = std::max(delay, milliseconds(retryAfterSeconds * 1000));
+        }
+
+        return std::min(delay, MAX_BULK_REPORT_RETRY_DELAY);
+    }
+
+    /**
+     * @brief Escapes a single CSV field.
+     * 
+     * @param field The field to escape.
+     * 
+     * @return string The quoted field. New lines are replaced with spaces so the row numbers stay intact.
+     */
+    static string getCsvField(const string& field) {
+        string escapedField = "\"";
+
+        for (const auto c : field) {
+            if (c == '"') { escapedField += "\"\""; }
+            else if (c == '\r' || c == '\n') { escapedField += ' '; }
+            else { escapedField += c; }
+        }
+
+        return escapedField + "\"";
+    }
+
+    /**
+     * @brief Generates a single CSV line compatible with AbuseIPDB's bulk-report endpoint.
+     * 
+     * @param report The report to serialise.
+     * 
+     * @return string The CSV line, including the trailing new line.
+     */
+    static string getBulkReportCsvLine(const AbuseIpDbApi::BulkReportEntry& report) {
+        const auto categoryList = getReportCategories(report.categories);
+        const time_t timestamp = report.timestamp == 0 ? time(nullptr) : report.timestamp;
+
+        tm utcTime{};
+        gmtime_r(&timestamp, &utcTime);
+        char dateBuffer[32] = { 0 };
+        strftime(dateBuffer, sizeof(dateBuffer), "%Y-%m-%dT%H:%M:%SZ", &utcTime);
+
+        string categories{};
+        for (const auto category : categoryList) {
+            categories += (categories.empty() ? "" : ",") + std::to_string(category);
+        }
+
+        return format("{:s},{:s},{:s},{:s}\n", report.ipAddress, getCsvField(categories), dateBuffer, getCsvField(report.comment));
+    }
+
+    /**
+     * @brief Generates a CSV compatible with AbuseIPDB's bulk-report endpoint.
+     * 
+     * @param lines The serialised reports, as returned by getBulkReportCsvLine.
+     * @param indices The indices of the lines to include.
+     * 
+     * @return string The CSV data, including the header.
+     */
+    static string getBulkReportCsv(const vector<string>& lines, const vector<size_t>& indices) {
+        string csv = BULK_REPORT_CSV_HEADER;
+
+        for (const auto index : indices) { csv += lines.at(index); }
+
+        return csv;
+    }
+
+    /**
+     * @brief Parses the response of a bulk report and maps all rejected rows back to the original reports.
+     * 
+     * If the whole request failed transiently, all sent rows are resubmitted; they are only recorded as invalid on the last attempt.
+     * 
+     * @param response The response returned by AbuseIPDB.
+     * @param reports The original list of reports.
+     * @param pendingIndices The indices of the reports which were sent, in the order they were sent.
+     * @param isLastAttempt Whether the rows may be resubmitted.
+     * @param result The result to merge the response into.
+     * 
+     * @return vector<size_t> The indices of the reports which should be resubmitted.
+     */
+    static vector<size_t> handleBulkReportResponse(const json& response, const vector<AbuseIpDbApi::BulkReportEntry>& reports,
+                                                   const vector<size_t>& pendingIndices, const bool isLastAttempt,
+                                                   AbuseIpDbApi::BulkReportResult& result) {
+        vector<size_t> retryIndices{};
+
+        if (response.is_null() || !response.contains("data")) {
+            if (!response.is_null() && response.contains("errors")) { result.errors = response.at("errors"); }
+
+            // nothing was saved; these rows are lost unless we try again
+            const auto isRetryable = isRetryableBulkFailure(response);
+            if (isRetryable && !isLastAttempt) { return pendingIndices; }
+
+            for (const auto index : pendingIndices) {
+                result.invalidReports.push_back({ "Request failed", reports.at(index).ipAddress, 0, index, isRetryable });
+            }
+
+            return retryIndices;
+        }
+
+        result.success = true;
+        const auto& data = response.at("data");
+        result.savedReports += data.value("savedReports", size_t(0));
+
+        if (!data.contains("invalidReports") || !data.at("invalidReports").is_array()) { return retryIndices; }
+
+        for (const auto& invalidReport : data.at("invalidReports")) {
+            AbuseIpDbApi::BulkReportResult::InvalidReport row{
+                invalidReport.value("error", string{}),
+                invalidReport.value("input", string{}),
+                invalidReport.value("rowNumber", size_t(0)),
+                SIZE_MAX, false
+            };
+            row.retryable = isRetryableBulkError(row.error);
+
+            // rowNumber counts the header as the first line; verify it by the input, just in case
+            const auto batchIndex = row.rowNumber - 2;
+            if (row.rowNumber >= 2 && batchIndex < pendingIndices.size() && reports.at(pendingIndices[batchIndex]).ipAddress == row.input) {
+                row.reportIndex = pendingIndices[batchIndex];
+            } else {
+                const auto pos = std::find_if(pendingIndices.begin(), pendingIndices.end(), [&](const size_t x) {
+                    return reports.at(x).ipAddress == row.input;
+                });
+                if (pos != pendingIndices.end()) { row.reportIndex = *pos; }
+            }
+
+            if (row.retryable && !isLastAttempt && row.reportIndex != SIZE_MAX) {
+                retryIndices.push_back(row.reportIndex);
+            } else {
+                result.invalidReports.push_back(row);
+            }
+        }
+
+        return retryIndices;
+    }
+
     /**
      * @brief Uploads a compatible CSV to AbuseIPDB
      * 
@@ -129,55 +603,184 @@ namespace abuseipdb_client { namespace api {
      * @return json The value returned from AbuseIPDB's API.
      */
     json AbuseIpDbApi::bulkReport(const string& csv) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::bulkReport", "api");
         initialiseCurl();
 
-        const static string API_URL = "https://api.abuseipdb.com/api/v2/bulk-report";
-        struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
-
         error_code err;
         if (!fs::exists(csv, err) || !fs::is_regular_file(csv, err)) {
             throw fs::filesystem_error("Csv must be a valid file!", err);
         }
 
-        size_t fileSize = fs::file_size(csv);
+        curl_mime* form = curl_mime_init(m_curl);
+        curl_mimepart* field = curl_mime_addpart(form);
 
-        FILE* fd = fopen(csv.c_str(), "rb");
-        if (!fd) {
+        // add csv
+        curl_mime_name(field, "csv");
+        if (curl_mime_filedata(field, csv.c_str()) != CURLcode::CURLE_OK) {
+            curl_mime_free(form);
             err = error_code(errno, std::system_category());
             throw fs::filesystem_error("Failed to open file", fs::path(csv), err);
         }
 
-        curl_easy_setopt(m_curl, CURLOPT_URL, API_URL.c_str());
-        curl_easy_setopt(m_curl, CURLOPT_CUSTOMREQUEST, "POST");
+        return postBulkReport(form);
+    }
 
-        curl_mime* form = curl_mime_init(m_curl);
-        curl_mimepart* field = curl_mime_addpart(form);
+    /**
+     * @brief Bulk-reports a list of reports and maps any rejected rows back to the passed reports.
+     * 
+     * Rows which were rejected for a transient reason are resubmitted in a follow-up batch containing only those rows;
+     * if the whole request failed transiently, all rows are resubmitted. Follow-up batches are delayed by an exponential backoff
+     * or the Retry-After sent by AbuseIPDB, whichever is longer.
+     * 
+     * @param reports The reports to upload. Must not exceed the limits of the bulk-report endpoint.
+     * @param maxRetries The maximum amount of follow-up batches.
+     * 
+     * @return BulkReportResult The merged result of all requests.
+     */
+    AbuseIpDbApi::BulkReportResult AbuseIpDbApi::bulkReport(const vector<BulkReportEntry>& reports, const size_t maxRetries) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::bulkReport", "api");
+        BulkReportResult result{};
 
-        // add csv
-        curl_mime_name(field, "csv");
-        curl_mime_filedata(field, csv.c_str());
+        vector<string> lines{};
+        lines.reserve(reports.size());
+        std::transform(reports.begin(), reports.end(), std::back_inserter(lines), getBulkReportCsvLine);
 
-        // add submit, just in case
-        field = curl_mime_addpart(form);
-        curl_mime_name(field, "submit");
-        curl_mime_data(field, "send", CURL_ZERO_TERMINATED);
+        vector<size_t> pendingIndices(reports.size());
+        std::iota(pendingIndices.begin(), pendingIndices.end(), 0);
 
-        curl_easy_setopt(m_curl, CURLOPT_MIMEPOST, form);
+        while (!pendingIndices.empty()) {
+            if (m_rateLimiter) { m_rateLimiter->acquire(); }
+            initialiseCurl();
 
-        auto retCode = curl_easy_perform(m_curl);
+            const auto csvData = getBulkReportCsv(lines, pendingIndices);
+            curl_mime* form = curl_mime_init(m_curl);
+            curl_mimepart* field = curl_mime_addpart(form);
 
-        if (retCode != CURLcode::CURLE_OK) {
-            m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
-            return json();
+            curl_mime_name(field, "csv");
+            curl_mime_filename(field, "report.csv");
+            curl_mime_type(field, "text/csv");
+            curl_mime_data(field, csvData.c_str(), csvData.size());
+
+            const auto response = postBulkReport(form);
+            const bool isLastAttempt = result.attempts++ >= maxRetries;
+
+            if (response.is_null() || !response.contains("data")) {
+                m_logger->error("Bulk report of {:d} rows failed!", pendingIndices.size());
+            }
+
+            auto retryIndices = handleBulkReportResponse(response, reports, pendingIndices, isLastAttempt, result);
+
+            if (!retryIndices.empty()) {
+                const auto delay = getBulkReportRetryDelay(m_curlResponseHeaders, result.attempts);
+                m_logger->info("Resubmitting {:d} of {:d} rows in {:d}ms", retryIndices.size(), pendingIndices.size(), delay.count());
+                std::this_thread::sleep_for(delay);
+            }
+
+            pendingIndices = std::move(retryIndices);
         }
-        
-        try {
-            return json::parse(m_curlResponse);
-        } catch (...) {
-            m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
-            return json();
+
+        return result;
+    }
+
+    /**
+     * @brief Bulk-reports an arbitrarily large list of reports.
+     * 
+     * The reports are split into chunks complying with the limits of the bulk-report endpoint,
+     * which are then uploaded concurrently (limited by the rate limiter, if set).
+     * Retryable rows of each chunk, or the whole chunk if its request failed transiently, are resubmitted in follow-up rounds.
+     * Each round waits for the longest backoff or Retry-After of the chunks it resubmits.
+     * 
+     * @param reports The reports to upload.
+     * @param maxConcurrent The maximum amount of concurrent uploads.
+     * @param maxRetries The maximum amount of follow-up batches per chunk.
+     * 
+     * @return vector<BulkReportResult> One result per chunk, in the order of the reports. Report indices refer to the passed list.
+     */
+    vector<AbuseIpDbApi::BulkReportResult> AbuseIpDbApi::bulkReportChunked(const vector<BulkReportEntry>& reports, const size_t maxConcurrent, const size_t maxRetries) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::bulkReportChunked", "api");
+        vector<string> lines{};
+        lines.reserve(reports.size());
+        std::transform(reports.begin(), reports.end(), std::back_inserter(lines), getBulkReportCsvLine);
+
+        // split into compliant chunks
+        vector<vector<size_t>> pendingIndices{};
+        size_t chunkSize = 0;
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (pendingIndices.empty() || pendingIndices.back().size() >= MAX_BULK_REPORT_LINES || chunkSize + lines[i].size() > MAX_BULK_REPORT_SIZE) {
+                pendingIndices.push_back({});
+                chunkSize = BULK_REPORT_CSV_HEADER.size();
+            }
+
+            pendingIndices.back().push_back(i);
+            chunkSize += lines[i].size();
+        }
+
+        m_logger->info("Uploading {:d} reports in {:d} chunks", reports.size(), pendingIndices.size());
+
+        vector<BulkReportResult> results(pendingIndices.size());
+        milliseconds retryDelay(0);
+
+        for (size_t attempt = 0; attempt <= maxRetries; attempt++) {
+            vector<size_t> chunks{};
+            for (size_t chunk = 0; chunk < pendingIndices.size(); chunk++) {
+                if (!pendingIndices[chunk].empty()) { chunks.push_back(chunk); }
+            }
+
+            if (chunks.empty()) { break; }
+
+            if (retryDelay.count() > 0) {
+                m_logger->info("Resubmitting {:d} chunks in {:d}ms", chunks.size(), retryDelay.count());
+                std::this_thread::sleep_for(retryDelay);
+                retryDelay = milliseconds(0);
+            }
+
+            performConcurrently(chunks.size(), maxConcurrent, m_rateLimiter.get(), [&](ConcurrentRequest& request) {
+                const auto chunk = chunks[request.indices.front()];
+                const auto csvData = getBulkReportCsv(lines, pendingIndices[chunk]);
+
+                request.headers = setHeaders(request.handle, m_apiKey);
+                request.form = curl_mime_init(request.handle);
+
+                curl_mimepart* field = curl_mime_addpart(request.form);
+                curl_mime_name(field, "csv");
+                curl_mime_filename(field, "report.csv");
+                curl_mime_type(field, "text/csv");
+                curl_mime_data(field, csvData.c_str(), csvData.size());
+
+                field = curl_mime_addpart(request.form);
+                curl_mime_name(field, "submit");
+                curl_mime_data(field, "send", CURL_ZERO_TERMINATED);
+
+                curl_easy_setopt(request.handle, CURLOPT_URL, BULK_REPORT_API_URL.c_str());
+                curl_easy_setopt(request.handle, CURLOPT_MIMEPOST, request.form);
+            }, [&](ConcurrentRequest& request) {
+                const auto chunk = chunks[request.indices.front()];
+                json response{};
+
+                recordRequest("bulk-report", request.handle, request.result, request.responseHeaders);
+
+                if (request.result != CURLcode::CURLE_OK) {
+                    m_logger->error("CURL failed for chunk {:d}: {:s} ({:d})", chunk, curl_easy_strerror(request.result), static_cast<int32_t>(request.result));
+                } else {
+                    try {
+                        ABUSEIPDB_TRACE_SPAN("json::parse", "api");
+                        response = json::parse(request.response);
+                    } catch (...) {
+                        m_logger->error("Failed to parse JSON of chunk {:d}!", chunk);
+                        SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", request.response);
+                    }
+                }
+
+                results[chunk].attempts++;
+                pendingIndices[chunk] = handleBulkReportResponse(response, reports, pendingIndices[chunk], attempt >= maxRetries, results[chunk]);
+
+                if (!pendingIndices[chunk].empty()) {
+                    retryDelay = std::max(retryDelay, getBulkReportRetryDelay(request.responseHeaders, results[chunk].attempts));
+                }
+            });
         }
+
+        return results;
     }
 
     /**
@@ -189,6 +792,7 @@ namespace abuseipdb_client { namespace api {
      * @return json THe AbuseIPDB response
      */
     json AbuseIpDbApi::checkBlocked(const string& networkAddress, const size_t subnetSize) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::checkBlocked", "api");
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/check-block";
@@ -197,10 +801,11 @@ namespace abuseipdb_client { namespace api {
         auto getParam = "network=" + getEscapedString(format("{:s}/{:d}", networkAddress, subnetSize), m_curl);
         
         auto url = format("{:s}?{:s}", API_URL, getParam);
-        m_logger->debug("Connecting to {:s}", url);
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
         curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("check-block", m_curl, retCode, m_curlResponseHeaders);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
@@ -211,34 +816,117 @@ namespace abuseipdb_client { namespace api {
         }
         
         try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
             return json::parse(m_curlResponse);
         } catch (...) {
             m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
             return json();
         }
     }
 
+    /**
+     * @brief Checks whether an IPv4 network of any size has reported addresses.
+     * 
+     * Networks larger than permitted by the subscription plan are split into the largest permissible sub-prefixes,
+     * which are checked concurrently (limited by the rate limiter, if set).
+     * The results are merged into a single, indexed SubnetReport.
+     * 
+     * @param networkAddress The network address. E.g. 193.41.0.0
+     * @param subnetSize The netmask (CIDR). E.g. 16
+     * @param result The merged result.
+     * @param maxConcurrent The maximum amount of concurrent requests.
+     * @param maxSubnetSize The largest subnet (smallest CIDR) permitted by the plan; see MAX_SUBNET_*.
+     * 
+     * @return true If all sub-prefixes were checked successfully. Failed sub-prefixes are listed in the result.
+     * 
+     * @throws std::invalid_argument If the address is invalid or the network would need more than MAX_CHECK_BLOCKED_REQUESTS requests.
+     */
+    bool AbuseIpDbApi::checkBlocked(const string& networkAddress, const size_t subnetSize, SubnetReport& result, const size_t maxConcurrent, const size_t maxSubnetSize) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::checkBlocked", "api");
+        const static string API_URL = "https://api.abuseipdb.com/api/v2/check-block";
+
+        result = SubnetReport();
+
+        uint32_t network = 0;
+        if (!utils::parseIpv4Address(networkAddress, network) || subnetSize > 32) {
+            throw std::invalid_argument("networkAddress must be a valid IPv4 network!");
+        }
+
+        const auto subPrefixLength = std::max(subnetSize, std::min<size_t>(maxSubnetSize, 32));
+        if ((size_t(1) << (subPrefixLength - subnetSize)) > MAX_CHECK_BLOCKED_REQUESTS) {
+            throw std::invalid_argument(format("/{:d} would require more than {:d} check-block requests!", subnetSize, MAX_CHECK_BLOCKED_REQUESTS));
+        }
+
+        const auto subnetCount = size_t(1) << (subPrefixLength - subnetSize);
+        const auto subnetStep = subPrefixLength == 32 ? 1 : uint64_t(1) << (32 - subPrefixLength);
+
+        result.networkAddress = subnetSize == 0 ? 0 : network & (~uint32_t(0) << (32 - subnetSize));
+        result.prefixLength = subnetSize;
+
+        m_logger->info("Checking {:s}/{:d} in {:d} requests", utils::formatIpv4Address(result.networkAddress), subnetSize, subnetCount);
+
+        const auto getSubnet = [&](const size_t index) {
+            return format("{:s}/{:d}", utils::formatIpv4Address(result.networkAddress + index * subnetStep), subPrefixLength);
+        };
+        vector<size_t> failedIndices{};
+
+        performConcurrently(subnetCount, maxConcurrent, m_rateLimiter.get(), [&](ConcurrentRequest& request) {
+            request.headers = setHeaders(request.handle, m_apiKey);
+
+            const auto url = format("{:s}?network={:s}", API_URL, getEscapedString(getSubnet(request.indices.front()), request.handle));
+            curl_easy_setopt(request.handle, CURLOPT_URL, url.c_str());
+        }, [&](ConcurrentRequest& request) {
+            SubnetReport subnetReport{};
+            recordRequest("check-block", request.handle, request.result, request.responseHeaders);
+
+            const auto index = request.indices.front();
+
+            if (request.result != CURLcode::CURLE_OK) {
+                m_logger->error("CURL failed for {:s}: {:s} ({:d})", getSubnet(index), curl_easy_strerror(request.result), static_cast<int32_t>(request.result));
+                failedIndices.push_back(index);
+            } else if (!parseSubnetReport(json::parse(request.response, nullptr, false), subnetReport)) {
+                m_logger->error("Failed to parse response for {:s}!", getSubnet(index));
+                SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", request.response);
+                failedIndices.push_back(index);
+            } else {
+                result.reportedAddresses.insert(result.reportedAddresses.end(), subnetReport.reportedAddresses.begin(), subnetReport.reportedAddresses.end());
+            }
+        });
+
+        // requests complete in any order
+        std::sort(failedIndices.begin(), failedIndices.end());
+        std::transform(failedIndices.begin(), failedIndices.end(), std::back_inserter(result.failedSubnets), getSubnet);
+        std::sort(result.reportedAddresses.begin(), result.reportedAddresses.end(), [](const auto& a, const auto& b) { return a.address < b.address; });
+
+        return result.failedSubnets.empty();
+    }
+
     /**
      * @brief Checks whether a given IP address has been reported before.
      * 
      * @param ipAddress The IP address to check
+     * @param maxAgeInDays Only consider reports within this many days (1-365).
+     * @param verbose Whether to include the reports (and country name) in the response. Can increase the response size considerably!
      * 
      * @return json The response value.
      */
-    json AbuseIpDbApi::checkIpAddress(const string& ipAddress) {
+    json AbuseIpDbApi::checkIpAddress(const string& ipAddress, const size_t maxAgeInDays, const bool verbose) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::checkIpAddress", "api");
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/check";
         struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
         
         auto ipParam = "ipAddress=" + getEscapedString(ipAddress, m_curl);
+        auto maxAgeParam = format("maxAgeInDays={:d}", std::clamp<size_t>(maxAgeInDays, 1, MAX_AGE_IN_DAYS));
         
-        auto url = format("{:s}?{:s}&verbose", API_URL, ipParam);
-        m_logger->debug("Connecting to {:s}", url);
+        auto url = format("{:s}?{:s}&{:s}{:s}", API_URL, ipParam, maxAgeParam, verbose ? "&verbose" : "");
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
         curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("check", m_curl, retCode, m_curlResponseHeaders);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
@@ -249,14 +937,89 @@ namespace abuseipdb_client { namespace api {
         }
         
         try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
             return json::parse(m_curlResponse);
         } catch (...) {
             m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
             return json();
         }
     }
 
+    /**
+     * @brief Checks whether a given IP address has been reported before.
+     * The response is parsed directly into a CheckResult.
+     * The reports are only requested if a callback is passed; they are handed to the callback one by one and never stored.
+     * If a local blacklist is set and contains the IP with sufficient confidence and a report within maxAgeInDays,
+     * a synthetic result is returned without sending a request (unless the reports were requested).
+     * 
+     * @param ipAddress The IP address to check
+     * @param result The output result.
+     * @param maxAgeInDays Only consider reports within this many days (1-365).
+     * @param onReport Invoked for each report of the IP. Pass nullptr if the reports aren't required.
+     * 
+     * @return true If the request succeeded and AbuseIPDB returned data for the IP.
+     */
+    bool AbuseIpDbApi::checkIpAddress(const string& ipAddress, CheckResult& result, const size_t maxAgeInDays, CheckReportCallback onReport) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::checkIpAddress", "api");
+        blacklist::BlackList::Entry entry{};
+
+        if (m_localBlackList && !onReport) {
+            // the confidence in the list covers the past 365 days; only answer locally if the last report is within the requested window
+            const auto oldestReport = time(nullptr) - static_cast<time_t>(std::clamp<size_t>(maxAgeInDays, 1, MAX_AGE_IN_DAYS) * 24 * 60 * 60);
+
+            if (m_localBlackList->find(ipAddress, entry) && entry.abuseConfidenceScore >= m_localBlackListMinConfidence &&
+                entry.lastReportedAt >= oldestReport) {
+                m_blackListHitCount++;
+
+                result = CheckResult();
+                result.isValid = true;
+                result.isPublic = true;
+                result.ipVersion = ipAddress.find(':') == string::npos ? 4 : 6;
+                result.abuseConfidenceScore = entry.abuseConfidenceScore;
+                result.lastReportedAt = entry.lastReportedAt;
+                result.countryCode[0] = entry.countryCode[0];
+                result.countryCode[1] = entry.countryCode[1];
+
+                return true;
+            }
+
+            m_blackListMissCount++;
+        }
+
+        initialiseCurl();
+
+        const static string API_URL = "https://api.abuseipdb.com/api/v2/check";
+        struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
+        
+        auto ipParam = "ipAddress=" + getEscapedString(ipAddress, m_curl);
+        auto maxAgeParam = format("maxAgeInDays={:d}", std::clamp<size_t>(maxAgeInDays, 1, MAX_AGE_IN_DAYS));
+        
+        auto url = format("{:s}?{:s}&{:s}{:s}", API_URL, ipParam, maxAgeParam, onReport ? "&verbose" : "");
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
+        curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
+        
+        auto retCode = performTransfer(m_curl);
+        recordRequest("check", m_curl, retCode, m_curlResponseHeaders);
+        
+        curl_slist_free_all(headers);
+        curl_easy_reset(m_curl);
+
+        if (retCode != CURLcode::CURLE_OK) {
+            m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
+            result = CheckResult();
+            return false;
+        }
+
+        if (!parseCheckResult(m_curlResponse, result, onReport)) {
+            m_logger->error("Failed to parse check result!");
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+            return false;
+        }
+
+        return true;
+    }
+
     /**
      * @brief Clears all reports of the passed IP address from the user account associated with the API key.
      * 
@@ -265,6 +1028,7 @@ namespace abuseipdb_client { namespace api {
      * @return json The response value.
      */
     json AbuseIpDbApi::clearIpAddress(const string& ipAddress) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::clearIpAddress", "api");
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/clear-address";
@@ -273,11 +1037,12 @@ namespace abuseipdb_client { namespace api {
         auto ipParam = "ipAddress=" + getEscapedString(ipAddress, m_curl);
         
         auto url = format("{:s}?{:s}&verbose", API_URL, ipParam);
-        m_logger->debug("Connecting to {:s}", url);
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
         curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(m_curl, CURLOPT_CUSTOMREQUEST, "DELETE");
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("clear-address", m_curl, retCode, m_curlResponseHeaders);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
@@ -288,10 +1053,11 @@ namespace abuseipdb_client { namespace api {
         }
         
         try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
             return json::parse(m_curlResponse);
         } catch (...) {
             m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
             return json();
         }
     }
@@ -304,27 +1070,18 @@ namespace abuseipdb_client { namespace api {
      * @return json The blacklist in JSON form.
      */
     json AbuseIpDbApi::getBlackList(const BlackListOptions& options) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::getBlackList", "api");
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/blacklist";
         struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
         
-        auto confidenceMinimum  = "confidenceMinimum=" + getEscapedString(std::to_string(options.minimumConfidence), m_curl);
-        auto limit              = "limit=" + getEscapedString(std::to_string(options.limit), m_curl);
-        auto countryList        = options.onlyCountries.size() > 0 ?
-                                  "onlyCountries=" + getEscapedString(
-                                    std::accumulate(options.onlyCountries.begin(), options.onlyCountries.end(), string{}), m_curl
-                                  )
-                                  :
-                                  "exceptCountries=" + getEscapedString(
-                                    std::accumulate(options.exceptCountries.begin(), options.exceptCountries.end(), string{}), m_curl
-                                  );
-        
-        auto url = format("{:s}?{:s}&{:s}&{:s}", API_URL, confidenceMinimum, limit, countryList);
-        m_logger->debug("Connecting to {:s}", url);
+        auto url = format("{:s}?{:s}", API_URL, getBlackListQuery(options, m_curl));
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
         curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("blacklist", m_curl, retCode, m_curlResponseHeaders);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
@@ -335,14 +1092,103 @@ namespace abuseipdb_client { namespace api {
         }
         
         try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
             return json::parse(m_curlResponse);
         } catch (...) {
             m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
             return json();
         }
     }
 
+    /**
+     * @brief Gets a blacklist from AbuseIPDB as a compact snapshot.
+     * 
+     * The request is conditional on the list having changed since it was last downloaded with the same options.
+     * If AbuseIPDB answers with 304 Not Modified, or sends a list with the same generation time, the cached snapshot is reused.
+     * 
+     * @param options A struct containing possible options for the blacklist.
+     * @param output The snapshot. Left untouched if the request failed.
+     * 
+     * @return true If a snapshot was downloaded or reused.
+     */
+    bool AbuseIpDbApi::getBlackList(const BlackListOptions& options, shared_ptr<const blacklist::BlackList>& output) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::getBlackList", "api");
+        initialiseCurl();
+
+        const static string API_URL = "https://api.abuseipdb.com/api/v2/blacklist";
+        auto url = format("{:s}?{:s}", API_URL, getBlackListQuery(options, m_curl));
+        auto& cache = m_blackListCache[url];
+
+        struct curl_slist* headers = cache.list ?
+            setHeaders(m_curl, m_apiKey, getConditionalHeaders(cache.eTag, cache.lastModified, cache.generatedAt)) :
+            setHeaders(m_curl, m_apiKey);
+        
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
+        curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
+        
+        auto retCode = performTransfer(m_curl);
+        recordRequest("blacklist", m_curl, retCode, m_curlResponseHeaders);
+
+        long httpStatus = 0;
+        curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &httpStatus);
+        
+        curl_slist_free_all(headers);
+        curl_easy_reset(m_curl);
+
+        if (retCode != CURLcode::CURLE_OK) {
+            m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
+            return false;
+        }
+
+        if (httpStatus == 304 && cache.list) {
+            SPDLOG_LOGGER_DEBUG(m_logger, "Blacklist not modified; reusing snapshot generated at {:d}", cache.generatedAt);
+            output = cache.list;
+            return true;
+        }
+
+        if (httpStatus != 200) {
+            m_logger->error("Failed to get blacklist: HTTP {:d}", httpStatus);
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+            return false;
+        }
+
+        json response{};
+        try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
+            response = json::parse(m_curlResponse);
+        } catch (...) {
+            m_logger->error("Failed to parse JSON!");
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+            return false;
+        }
+
+        time_t generatedAt = 0;
+        if (response.contains("meta") && response.at("meta").is_object()) {
+            utils::parseTimestamp(response.at("meta").value("generatedAt", string{}), generatedAt);
+        }
+
+        if (!cache.list || generatedAt == 0 || generatedAt != cache.generatedAt) {
+            auto list = blacklist::BlackList::fromJson(response);
+            if (!list) {
+                m_logger->error("Failed to parse blacklist!");
+                SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+                return false;
+            }
+
+            cache.list = list;
+            cache.generatedAt = list->getGeneratedAt();
+        } else {
+            SPDLOG_LOGGER_DEBUG(m_logger, "Blacklist unchanged; reusing snapshot generated at {:d}", cache.generatedAt);
+        }
+
+        cache.eTag = getResponseHeader(m_curlResponseHeaders, "ETag");
+        cache.lastModified = getResponseHeader(m_curlResponseHeaders, "Last-Modified");
+
+        output = cache.list;
+        return true;
+    }
+
     /**
      * @brief Reports the passed IP address.
      * 
@@ -353,16 +1199,30 @@ namespace abuseipdb_client { namespace api {
      * @return json The response value.
      */
     json AbuseIpDbApi::reportIp(const string& ipAddress, const ReportCategories categories, const string& comment) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::reportIp", "api");
+        if (categories == static_cast<ReportCategories>(0)) {
+            throw std::invalid_argument("categories must be a valid category!");
+        }
+
+        auto reportedCategories = static_cast<uint64_t>(categories);
+        uint64_t mergedCategories = 0;
+        if (m_reportSuppressor && !m_reportSuppressor->tryReport(ipAddress, reportedCategories, mergedCategories)) {
+            SPDLOG_LOGGER_DEBUG(m_logger, "Suppressed duplicate report of {:s}", ipAddress);
+
+            // mimic the response AbuseIPDB would have sent
+            return json{ { "errors", json::array({ {
+                { "detail", format("You can only report the same IP address (`{:s}`) once in 15 minutes. (suppressed locally)", ipAddress) },
+                { "status", 429 },
+                { "source", { { "parameter", "ip" } } }
+            } }) } };
+        }
+
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/report";
         struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
 
-        if (categories == static_cast<ReportCategories>(0)) {
-            throw std::invalid_argument("categories must be a valid category!");
-        }
-
-        auto categoryList = getReportCategories(categories);
+        auto categoryList = getReportCategories(static_cast<ReportCategories>(reportedCategories));
 
         if (categoryList.size() == 0) {
             throw std::runtime_error("Failed to parse categories!");
@@ -380,75 +1240,262 @@ namespace abuseipdb_client { namespace api {
         auto commentParam    = "comment=" + getEscapedString(comment, m_curl);
         
         auto postParams = format("{:s}&{:s}&{:s}", ip, categoryParam, commentParam);
-        m_logger->debug("Connecting to {:s}", API_URL);
-        m_logger->debug("Post fields: {:s}", postParams);
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", API_URL);
+        SPDLOG_LOGGER_DEBUG(m_logger, "Post fields: {:s}", postParams);
         curl_easy_setopt(m_curl, CURLOPT_URL, API_URL.c_str());
         curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, postParams.c_str());
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("report", m_curl, retCode, m_curlResponseHeaders);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
 
+        json response{};
         if (retCode != CURLcode::CURLE_OK) {
             m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
-            return json();
-        }
-        
-        try {
-            return json::parse(m_curlResponse);
-        } catch (...) {
-            m_logger->error("Failed to parse JSON!");
-            m_logger->trace("Erronious output: {:s}", m_curlResponse);
-            return json();
+        } else {
+            try {
+                ABUSEIPDB_TRACE_SPAN("json::parse", "api");
+                response = json::parse(m_curlResponse);
+            } catch (...) {
+                m_logger->error("Failed to parse JSON!");
+                SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+            }
         }
+
+        // nothing was saved (e.g. errors, throttling or an error page), so the IP must not be suppressed
+        // the suppressed categories merged into this report are restored, so they aren't lost
+        if (m_reportSuppressor && (!response.is_object() || !response.contains("data"))) { m_reportSuppressor->forget(ipAddress, mergedCategories); }
+
+        return response;
     }
 
     /**
      * @brief Gets a blacklist from AbuseIPDB with certain options in plaintext.
      * 
+     * The request is conditional on the list having changed since it was last downloaded with the same options;
+     * if AbuseIPDB answers with 304 Not Modified, the cached list is returned.
+     * 
      * @param options The options to apply to the blacklist. Supply an empty object to use defaults.
      * 
      * @return string The blacklist in plaintext.
      */
     string AbuseIpDbApi::getBlackListPlaintext(const BlackListOptions& options) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::getBlackListPlaintext", "api");
         initialiseCurl();
 
         const static string API_URL = "https://api.abuseipdb.com/api/v2/blacklist";
-        struct curl_slist* headers = setHeaders(m_curl, m_apiKey, map<string, string>{ { "Accept", "text/plain" } });
-        
-        auto confidenceMinimum  = "confidenceMinimum=" + getEscapedString(std::to_string(options.minimumConfidence), m_curl);
-        auto limit              = "limit=" + getEscapedString(std::to_string(options.limit), m_curl);
-        auto countryList        = options.onlyCountries.size() > 0 ?
-                                  "onlyCountries=" + getEscapedString(
-                                    std::accumulate(options.onlyCountries.begin(), options.onlyCountries.end(), string{}), m_curl
-                                  )
-                                  :
-                                  "exceptCountries=" + getEscapedString(
-                                    std::accumulate(options.exceptCountries.begin(), options.exceptCountries.end(), string{}), m_curl
-                                  );
+        auto url = format("{:s}?{:s}&plaintext", API_URL, getBlackListQuery(options, m_curl));
+        auto& cache = m_blackListCache[url];
+
+        auto otherHeaders = cache.plaintext.empty() ? map<string, string>{} : getConditionalHeaders(cache.eTag, cache.lastModified, 0);
+        otherHeaders["Accept"] = "text/plain";
+        struct curl_slist* headers = setHeaders(m_curl, m_apiKey, otherHeaders);
         
-        auto url = format("{:s}?{:s}&{:s}&{:s}&plaintext", API_URL, confidenceMinimum, limit, countryList);
-        m_logger->debug("Connecting to {:s}", url);
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", url);
         curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
         
-        auto retCode = curl_easy_perform(m_curl);
+        auto retCode = performTransfer(m_curl);
+        recordRequest("blacklist", m_curl, retCode, m_curlResponseHeaders);
+
+        long httpStatus = 0;
+        curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &httpStatus);
         
         curl_slist_free_all(headers);
         curl_easy_reset(m_curl);
 
         if (retCode != CURLcode::CURLE_OK) {
             m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
-            return json();
+            return string();
+        }
+
+        if (httpStatus == 304 && !cache.plaintext.empty()) {
+            SPDLOG_LOGGER_DEBUG(m_logger, "Blacklist not modified; reusing cached list");
+            return cache.plaintext;
         }
         
         try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
             return json::parse(m_curlResponse).dump(2);
         } catch (...) {
+            // only a successful response is a list; anything else (e.g. an HTML error page) must not replace the cache
+            if (httpStatus == 200) {
+                cache.eTag = getResponseHeader(m_curlResponseHeaders, "ETag");
+                cache.lastModified = getResponseHeader(m_curlResponseHeaders, "Last-Modified");
+                cache.plaintext = m_curlResponse;
+            }
+
             return m_curlResponse;
         }
     }
 
+    /**
+     * @brief Posts a multipart form containing a CSV to the bulk-report endpoint.
+     * 
+     * @param form The form containing the CSV. Is freed by this method.
+     * 
+     * @return json The value returned from AbuseIPDB's API.
+     */
+    json AbuseIpDbApi::postBulkReport(curl_mime* form) {
+        ABUSEIPDB_TRACE_SPAN("AbuseIpDbApi::postBulkReport", "api");
+        struct curl_slist* headers = setHeaders(m_curl, m_apiKey);
+
+        // add submit, just in case
+        curl_mimepart* field = curl_mime_addpart(form);
+        curl_mime_name(field, "submit");
+        curl_mime_data(field, "send", CURL_ZERO_TERMINATED);
+
+        SPDLOG_LOGGER_DEBUG(m_logger, "Connecting to {:s}", BULK_REPORT_API_URL);
+        curl_easy_setopt(m_curl, CURLOPT_URL, BULK_REPORT_API_URL.c_str());
+        curl_easy_setopt(m_curl, CURLOPT_MIMEPOST, form);
+
+        auto retCode = performTransfer(m_curl);
+        recordRequest("bulk-report", m_curl, retCode, m_curlResponseHeaders);
+
+        curl_slist_free_all(headers);
+        curl_easy_reset(m_curl);
+        curl_mime_free(form);
+
+        if (retCode != CURLcode::CURLE_OK) {
+            m_logger->error("CURL failed: {:s} ({:d})", curl_easy_strerror(retCode), retCode);
+            return json();
+        }
+        
+        try {
+            ABUSEIPDB_TRACE_SPAN("json::parse", "api");
+            return json::parse(m_curlResponse);
+        } catch (...) {
+            m_logger->error("Failed to parse JSON!");
+            SPDLOG_LOGGER_TRACE(m_logger, "Erronious output: {:s}", m_curlResponse);
+            return json();
+        }
+    }
+
+    /**
+     * @brief Records the outcome and timing of a finished transfer.
+     * 
+     * The timing is passed to the request trace callback and, if a metrics registry is set, recorded as
+     * total and per-phase latencies along with the transferred bytes and connection reuse.
+     * Must be called before the handle is reset, as the status and timing info is lost afterwards.
+     * The quota headers sent by AbuseIPDB are exported as gauges, so throttling can be detected before
+     * requests start failing with 429 Too Many Requests.
+     * 
+     * @param endpoint The name of the API endpoint, used as label.
+     * @param handle The easy handle which performed the transfer.
+     * @param result The result of the transfer.
+     * @param responseHeaders The raw response headers.
+     */
+    void AbuseIpDbApi::recordRequest(const string& endpoint, CURL* handle, const CURLcode result, const string& responseHeaders) {
+        const auto timing = getRequestTiming(endpoint, handle, result);
+
+        SPDLOG_LOGGER_TRACE(
+            m_logger, "{:s}: HTTP {:d} in {:d}us (dns {:d}us, connect {:d}us, tls {:d}us, server {:d}us, transfer {:d}us), {:d}B down, {:d}B up, {:s} connection",
+            endpoint, timing.httpStatus, timing.total.count(), timing.getNameLookupTime().count(), timing.getConnectTime().count(), timing.getTlsTime().count(),
+            timing.getServerTime().count(), timing.getTransferTime().count(), timing.bytesDownloaded, timing.bytesUploaded, timing.connectionReused ? "reused" : "new"
+        );
+
+        if (m_requestTraceCallback) { m_requestTraceCallback(timing); }
+
+        if (timing.httpStatus == 429) {
+            m_logger->warn("AbuseIPDB is throttling requests to {:s}; retry after {:s}s", endpoint, getResponseHeader(responseHeaders, "Retry-After"));
+        }
+
+        if (!m_metrics) { return; }
+
+        auto& endpointMetrics = getEndpointMetrics(endpoint);
+
+        auto& requests = endpointMetrics.requests[{ result, timing.httpStatus }];
+        if (!requests) {
+            requests = m_metrics->getCounter(
+                "abuseipdb_requests_total", "Requests sent to AbuseIPDB by endpoint, curl result and HTTP status.",
+                { { "endpoint", endpoint }, { "curl_code", std::to_string(static_cast<int32_t>(result)) }, { "http_status", std::to_string(timing.httpStatus) } }
+            ).get();
+        }
+        requests->increment();
+
+        auto& duration = endpointMetrics.durations[timing.httpStatus];
+        if (!duration) {
+            duration = m_metrics->getHistogram(
+                "abuseipdb_request_duration_seconds", "Total time of requests sent to AbuseIPDB.",
+                { { "endpoint", endpoint }, { "http_status", std::to_string(timing.httpStatus) } }
+            ).get();
+        }
+        duration->observeMicros(timing.total.count());
+
+        const microseconds phaseDurations[] = {
+            timing.getNameLookupTime(), timing.getConnectTime(), timing.getTlsTime(), timing.getServerTime(), timing.getTransferTime()
+        };
+        for (size_t i = 0; i < std::size(phaseDurations); i++) {
+            endpointMetrics.phaseDurations[i]->observeMicros(phaseDurations[i].count());
+        }
+
+        endpointMetrics.responseBytes->increment(timing.bytesDownloaded);
+        endpointMetrics.requestBytes->increment(timing.bytesUploaded);
+        endpointMetrics.connections[timing.connectionReused ? 1 : 0]->increment();
+
+        const auto remaining = getResponseHeader(responseHeaders, "X-RateLimit-Remaining");
+        if (!remaining.empty()) {
+            // only created once AbuseIPDB reported a quota, so a missing header isn't exported as an exhausted quota
+            if (!endpointMetrics.rateLimitRemaining) {
+                endpointMetrics.rateLimitRemaining = m_metrics->getGauge(
+                    "abuseipdb_ratelimit_remaining", "Requests remaining in the current quota window, as reported by AbuseIPDB.", { { "endpoint", endpoint } }
+                ).get();
+            }
+            endpointMetrics.rateLimitRemaining->set(std::strtod(remaining.c_str(), nullptr));
+        }
+
+        const auto limit = getResponseHeader(responseHeaders, "X-RateLimit-Limit");
+        if (!limit.empty()) {
+            if (!endpointMetrics.rateLimitLimit) {
+                endpointMetrics.rateLimitLimit = m_metrics->getGauge(
+                    "abuseipdb_ratelimit_limit", "Size of the quota window, as reported by AbuseIPDB.", { { "endpoint", endpoint } }
+                ).get();
+            }
+            endpointMetrics.rateLimitLimit->set(std::strtod(limit.c_str(), nullptr));
+        }
+    }
+
+    /**
+     * @brief Gets the series recorded for an endpoint, creating them in the registry on first use.
+     * 
+     * Series which depend on the response (status labels, quota gauges) are resolved by recordRequest() as they occur.
+     * 
+     * @param endpoint The name of the endpoint.
+     * 
+     * @return EndpointMetrics& The cached series.
+     */
+    AbuseIpDbApi::EndpointMetrics& AbuseIpDbApi::getEndpointMetrics(const string& endpoint) {
+        auto cached = m_endpointMetrics.find(endpoint);
+        if (cached != m_endpointMetrics.end()) { return cached->second; }
+
+        auto& endpointMetrics = m_endpointMetrics[endpoint];
+
+        const char* phases[] = { "dns", "connect", "tls", "server", "transfer" };
+        for (size_t i = 0; i < std::size(phases); i++) {
+            endpointMetrics.phaseDurations[i] = m_metrics->getHistogram(
+                "abuseipdb_request_phase_duration_seconds", "Time spent in each phase of requests sent to AbuseIPDB.",
+                { { "endpoint", endpoint }, { "phase", phases[i] } }
+            ).get();
+        }
+
+        for (const auto isReused : { false, true }) {
+            endpointMetrics.connections[isReused] = m_metrics->getCounter(
+                "abuseipdb_connections_total", "Requests sent to AbuseIPDB by whether they reused an existing connection.",
+                { { "endpoint", endpoint }, { "reused", isReused ? "true" : "false" } }
+            ).get();
+        }
+
+        endpointMetrics.responseBytes = m_metrics->getCounter(
+            "abuseipdb_response_bytes_total", "Response body bytes received from AbuseIPDB, before decompression.", { { "endpoint", endpoint } }
+        ).get();
+        endpointMetrics.requestBytes = m_metrics->getCounter(
+            "abuseipdb_request_bytes_total", "Request body bytes sent to AbuseIPDB.", { { "endpoint", endpoint } }
+        ).get();
+
+        return endpointMetrics;
+    }
+
     /**
      * @brief Initialises the CURL library
      * 
@@ -461,9 +1508,10 @@ namespace abuseipdb_client { namespace api {
 
         curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, handleCurlWrite);
         curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &m_curlResponse);
-        curl_easy_setopt(m_curl, CURLOPT_WRITEHEADER, &m_curlResponseHeaders);
+        curl_easy_setopt(m_curl, CURLOPT_HEADERFUNCTION, handleCurlWrite);
+        curl_easy_setopt(m_curl, CURLOPT_HEADERDATA, &m_curlResponseHeaders);
+        curl_easy_setopt(m_curl, CURLOPT_ACCEPT_ENCODING, ""); // all encodings supported by libcurl (gzip, deflate, br, ...)
         curl_easy_setopt(m_curl, CURLOPT_DNS_LOCAL_IP4, 1);
-        curl_easy_setopt(m_curl, CURLOPT_WRITEHEADER, 0);
 
         #ifdef abuseipdb_DEBUG
         // curl_easy_setopt(m_curl, CURLOPT_VERBOSE, 1);
@@ -0,0 +1,89 @@
+/**
+ * @file CheckPlanner.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the CheckPlanner class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/CheckPlanner.hpp"
+#include "api/SubnetReport.hpp"
+#include "util/Utilities.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using std::map;
+    using std::pair;
+
+    const size_t CheckPlanner::DEFAULT_CLUSTER_THRESHOLD = 4;
+    const size_t CheckPlanner::DEFAULT_PREFIX_LENGTH = 24;
+
+    /**
+     * @brief Checks all passed addresses.
+     * 
+     * @param ipAddresses The addresses to check. Duplicates are only checked once.
+     * 
+     * @return unordered_map<string, CheckResult> The results, keyed by address. Failed checks have an invalid result.
+     */
+    unordered_map<string, CheckResult> CheckPlanner::checkIpAddresses(const vector<string>& ipAddresses) {
+        unordered_map<string, CheckResult> results{};
+        map<uint32_t, vector<pair<uint32_t, string>>> prefixes{};
+        vector<string> singleChecks{};
+
+        const uint32_t netmask = m_prefixLength == 0 ? 0 : ~uint32_t(0) << (32 - std::min<size_t>(m_prefixLength, 32));
+
+        // group by prefix
+        for (const auto& ipAddress : ipAddresses) {
+            if (!results.emplace(ipAddress, CheckResult()).second) { continue; } // duplicate
+
+            uint32_t address = 0;
+            if (utils::parseIpv4Address(ipAddress, address)) {
+                prefixes[address & netmask].emplace_back(address, ipAddress);
+            } else {
+                singleChecks.push_back(ipAddress);
+            }
+        }
+
+        for (const auto& prefix : prefixes) {
+            if (prefix.second.size() < std::max<size_t>(m_clusterThreshold, 2)) {
+                for (const auto& member : prefix.second) { singleChecks.push_back(member.second); }
+                continue;
+            }
+
+            SubnetReport subnetReport{};
+            m_requestCount++;
+
+            if (!parseSubnetReport(m_api->checkBlocked(utils::formatIpv4Address(prefix.first), m_prefixLength), subnetReport)) {
+                // fall back to checking the members one by one
+                for (const auto& member : prefix.second) { singleChecks.push_back(member.second); }
+                continue;
+            }
+
+            for (const auto& member : prefix.second) { results[member.second] = subnetReport.getCheckResult(member.first); }
+            m_savedRequestCount += prefix.second.size() - 1;
+        }
+
+        for (const auto& ipAddress : singleChecks) {
+            m_requestCount++;
+            m_api->checkIpAddress(ipAddress, results[ipAddress]);
+        }
+
+        return results;
+    }
+
+} /* namespace api */ } /* abuseipdb_client */
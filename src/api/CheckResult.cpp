@@ -0,0 +1,224 @@
+/**
+ * @file CheckResult.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the SAX parser filling CheckResult instances.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+
+// nlohmann/json
+#include <nlohmann/json.hpp>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/CheckResult.hpp"
+#include "trace/TraceRecorder.hpp"
+#include "util/Utilities.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using nlohmann::json;
+
+    using std::array;
+    using std::pair;
+
+    /**
+     * @brief SAX handler which fills a CheckResult from the members of the "data" object.
+     * 
+     * Only scalar values directly within "data" are considered; nested arrays and objects (hostnames)
+     * are skipped without being materialised.
+     * If a callback is set, each element of the reports array is parsed into a single, reused CheckReport
+     * which is passed to the callback as soon as the element is complete.
+     */
+    class CheckResultSaxHandler: public nlohmann::json_sax<json> {
+        public: // +++ Constructor / Destructor +++
+            CheckResultSaxHandler(CheckResult& result, CheckReportCallback onReport):
+                m_isInCategories(false), m_depth(0), m_dataDepth(0), m_reportsDepth(0), m_key(), m_report(),
+                m_onReport(onReport), m_result(result) {}
+            virtual ~CheckResultSaxHandler() {}
+
+        public: // +++ SAX Interface +++
+            bool null() override { return true; }
+            bool boolean(bool val) override {
+                if (!isDataMember()) { return true; }
+
+                if (m_key == "isPublic")            { m_result.isPublic = val; }
+                else if (m_key == "isWhitelisted")  { m_result.isWhitelisted = val; }
+
+                return true;
+            }
+            bool number_integer(number_integer_t val) override { return number_unsigned(static_cast<number_unsigned_t>(std::max<number_integer_t>(val, 0))); }
+            bool number_unsigned(number_unsigned_t val) override {
+                if (m_isInCategories && m_depth == m_reportsDepth + 2) {
+                    if (val > 0 && val <= 64) { m_report.categories |= uint64_t(1) << (val - 1); }
+                    return true;
+                }
+
+                if (isReportMember()) {
+                    if (m_key == "reporterId") { m_report.reporterId = val; }
+                    return true;
+                }
+
+                if (!isDataMember()) { return true; }
+
+                if (m_key == "abuseConfidenceScore")    { m_result.abuseConfidenceScore = std::min<number_unsigned_t>(val, 100); }
+                else if (m_key == "totalReports")       { m_result.totalReports = val; }
+                else if (m_key == "numDistinctUsers")   { m_result.numDistinctUsers = val; }
+                else if (m_key == "ipVersion")          { m_result.ipVersion = val; }
+
+                return true;
+            }
+            bool number_float(number_float_t val, const string_t&) override { return number_unsigned(val < 0 ? 0 : static_cast<number_unsigned_t>(val)); }
+            bool string(string_t& val) override {
+                if (isReportMember()) {
+                    if (m_key == "comment") {
+                        m_report.comment = std::move(val);
+                    } else if (m_key == "reportedAt") {
+                        utils::parseTimestamp(val, m_report.reportedAt);
+                    } else if (m_key == "reporterCountryCode" && val.size() == 2) {
+                        m_report.reporterCountryCode[0] = val[0];
+                        m_report.reporterCountryCode[1] = val[1];
+                    }
+                    return true;
+                }
+
+                if (!isDataMember()) { return true; }
+
+                if (m_key == "countryCode" && val.size() == 2) {
+                    m_result.countryCode[0] = val[0];
+                    m_result.countryCode[1] = val[1];
+                } else if (m_key == "usageType") {
+                    m_result.usageType = getUsageType(val);
+                } else if (m_key == "lastReportedAt") {
+                    utils::parseTimestamp(val, m_result.lastReportedAt);
+                }
+
+                return true;
+            }
+            bool binary(binary_t&) override { return true; }
+            bool start_object(std::size_t) override {
+                if (m_depth == 1 && m_key == "data") {
+                    m_dataDepth = m_depth + 1;
+                    m_result.isValid = true;
+                } else if (m_reportsDepth > 0 && m_depth == m_reportsDepth) {
+                    m_report = CheckReport();
+                }
+
+                m_depth++;
+                return true;
+            }
+            bool key(string_t& val) override {
+                m_key = val;
+                return true;
+            }
+            bool end_object() override {
+                m_depth--;
+                m_key.clear();
+
+                if (m_reportsDepth > 0 && m_depth == m_reportsDepth) { m_onReport(m_report); }
+
+                return true;
+            }
+            bool start_array(std::size_t) override {
+                if (m_onReport && isDataMember() && m_key == "reports") {
+                    m_reportsDepth = m_depth + 1;
+                } else if (isReportMember() && m_key == "categories") {
+                    m_isInCategories = true;
+                }
+
+                m_depth++;
+                return true;
+            }
+            bool end_array() override {
+                m_depth--;
+
+                if (m_isInCategories && isReportMember()) {
+                    m_isInCategories = false;
+                } else if (m_reportsDepth > 0 && m_depth + 1 == m_reportsDepth) {
+                    m_reportsDepth = 0;
+                }
+
+                return true;
+            }
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override { return false; }
+
+        private: // +++ Private API +++
+            bool isDataMember() const { return m_dataDepth > 0 && m_depth == m_dataDepth; }
+            bool isReportMember() const { return m_reportsDepth > 0 && m_depth == m_reportsDepth + 1; }
+
+        private: // +++ Member Variables +++
+            bool                m_isInCategories;
+
+            size_t              m_depth;
+            size_t              m_dataDepth;
+            size_t              m_reportsDepth; //!< The depth of the elements of the reports array; 0 if not within it
+
+            string_t            m_key;
+
+            CheckReport         m_report;
+
+            CheckReportCallback m_onReport;
+
+            CheckResult&        m_result;
+    };
+
+    /**
+     * @brief Converts a usage type as returned by AbuseIPDB to its enum value.
+     * 
+     * @param usageType The usage type string, e.g. "Data Center/Web Hosting/Transit"
+     * 
+     * @return CheckResult::UsageType The usage type; Unknown if it isn't known.
+     */
+    CheckResult::UsageType getUsageType(const string_view usageType) {
+        using usage_t = CheckResult::UsageType;
+
+        const static array<pair<string_view, usage_t>, 12> USAGE_TYPES = {{
+            { "Commercial",                         usage_t::Commercial },
+            { "Organization",                       usage_t::Organization },
+            { "Government",                         usage_t::Government },
+            { "Military",                           usage_t::Military },
+            { "University/College/School",          usage_t::UniversityCollegeSchool },
+            { "Library",                            usage_t::Library },
+            { "Content Delivery Network",           usage_t::ContentDeliveryNetwork },
+            { "Fixed Line ISP",                     usage_t::FixedLineIsp },
+            { "Mobile ISP",                         usage_t::MobileIsp },
+            { "Data Center/Web Hosting/Transit",    usage_t::DataCenterWebHostingTransit },
+            { "Search Engine Spider",               usage_t::SearchEngineSpider },
+            { "Reserved",                           usage_t::Reserved }
+        }};
+
+        const auto pos = std::find_if(USAGE_TYPES.begin(), USAGE_TYPES.end(), [&](const auto& x) { return x.first == usageType; });
+
+        return pos == USAGE_TYPES.end() ? usage_t::Unknown : pos->second;
+    }
+
+    /**
+     * @brief Parses the response of the check endpoint without building a JSON DOM.
+     * 
+     * @param response The raw response.
+     * @param result The output result.
+     * @param onReport If set, invoked for each element of the reports array of a verbose response.
+     * 
+     * @return true If the response was valid JSON and contained a data object.
+     */
+    bool parseCheckResult(const string& response, CheckResult& result, CheckReportCallback onReport) {
+        ABUSEIPDB_TRACE_SPAN("parseCheckResult", "parse");
+        result = CheckResult();
+        CheckResultSaxHandler handler(result, onReport);
+
+        return json::sax_parse(response, &handler) && result.isValid;
+    }
+
+} /* namespace api */ } /* abuseipdb_client */
@@ -0,0 +1,91 @@
+/**
+ * @file RateLimiter.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the RateLimiter class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/RateLimiter.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using std::chrono::duration;
+    using std::chrono::duration_cast;
+    using std::lock_guard;
+
+    /**
+     * @brief Constructs a new RateLimiter.
+     * 
+     * @param requestsPerSecond The sustained amount of requests per second. May be lower than 1; zero disables the limit.
+     * @param burst The maximum amount of requests which may be sent at once.
+     */
+    RateLimiter::RateLimiter(const double requestsPerSecond, const size_t burst):
+        m_burst(std::max<double>(burst, 1)), m_requestsPerSecond(requestsPerSecond),
+        m_tokens(std::max<double>(burst, 1)), m_lastRefill(steady_clock::now()) {}
+
+    /**
+     * @brief Blocks the calling thread until a token could be consumed.
+     */
+    void RateLimiter::acquire() {
+        while (!tryAcquire()) {
+            std::this_thread::sleep_for(std::max(getWaitTime(), milliseconds(1)));
+        }
+    }
+
+    /**
+     * @brief Consumes a token, if one is available.
+     * 
+     * @return true If a token was consumed and a request may be sent.
+     */
+    bool RateLimiter::tryAcquire() {
+        lock_guard<mutex> lock(m_mutex);
+        refill();
+
+        if (m_requestsPerSecond <= 0) { return true; } // unlimited
+        if (m_tokens < 1) { return false; }
+
+        m_tokens -= 1;
+        return true;
+    }
+
+    /**
+     * @brief Gets the time remaining until the next token is available.
+     * 
+     * @return milliseconds The wait time; zero if a token is available.
+     */
+    milliseconds RateLimiter::getWaitTime() {
+        lock_guard<mutex> lock(m_mutex);
+        refill();
+
+        if (m_tokens >= 1 || m_requestsPerSecond <= 0) { return milliseconds(0); }
+
+        return duration_cast<milliseconds>(duration<double>((1 - m_tokens) / m_requestsPerSecond)) + milliseconds(1);
+    }
+
+    /**
+     * @brief Adds the tokens accumulated since the last refill. Must be called with the mutex held.
+     */
+    void RateLimiter::refill() {
+        const auto now = steady_clock::now();
+        const auto elapsed = duration<double>(now - m_lastRefill).count();
+
+        m_tokens = std::min(m_burst, m_tokens + elapsed * m_requestsPerSecond);
+        m_lastRefill = now;
+    }
+
+} /* namespace api */ } /* abuseipdb_client */
@@ -0,0 +1,203 @@
+/**
+ * @file ReportSuppressor.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the ReportSuppressor class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/ReportSuppressor.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using std::chrono::duration_cast;
+    using std::chrono::minutes;
+    using std::lock_guard;
+
+    const seconds ReportSuppressor::DEFAULT_SUPPRESSION_PERIOD = minutes(15);
+    const seconds ReportSuppressor::DEFAULT_RESOLUTION = minutes(1);
+
+    /**
+     * @brief Constructs a new ReportSuppressor.
+     * 
+     * @param period The period in which an IP may only be reported once.
+     * @param resolution The size of a single slot of the expiry wheel.
+     */
+    ReportSuppressor::ReportSuppressor(const seconds period, const seconds resolution):
+        m_lastTick(0), m_period(period), m_resolution(std::max(resolution, seconds(1))), m_suppressedCount(0), m_entries({}),
+        m_wheel(period / std::max(resolution, seconds(1)) + 2) {
+        m_lastTick = getTick(steady_clock::now());
+    }
+
+    /**
+     * @brief Checks whether a report for a given IP may be sent.
+     * 
+     * If the IP was reported within the suppression period, its categories are stored and merged into
+     * the next report which is allowed through.
+     * 
+     * @param ipAddress The IP address to report.
+     * @param categories The categories of the report. Is OR'd with the categories of previously suppressed reports if the report may be sent.
+     * @param mergedCategories Set to the categories of previously suppressed reports which were merged into categories.
+     * @param now The current time.
+     * 
+     * @return true If the report should be sent.
+     * @return false If the report was suppressed.
+     */
+    bool ReportSuppressor::tryReport(const string& ipAddress, uint64_t& categories, uint64_t& mergedCategories, const steady_clock::time_point now) {
+        lock_guard<mutex> lock(m_mutex);
+
+        mergedCategories = 0;
+
+        const auto currentTick = getTick(now);
+        expire(currentTick);
+
+        auto entry = m_entries.find(ipAddress);
+        if (entry != m_entries.end() && now - entry->second.reportedAt < m_period) {
+            entry->second.pendingCategories |= categories;
+            m_suppressedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (entry == m_entries.end()) {
+            entry = m_entries.emplace(ipAddress, Entry{ now, currentTick, 0 }).first;
+        } else {
+            // expired, but the wheel hasn't come around yet or the entry is kept for its pending categories
+            mergedCategories = entry->second.pendingCategories;
+            categories |= mergedCategories;
+            entry->second = Entry{ now, currentTick, 0 };
+        }
+
+        m_wheel[currentTick % m_wheel.size()].push_back(ipAddress);
+
+        return true;
+    }
+
+    /**
+     * @brief Allows an IP to be reported again immediately.
+     * 
+     * Categories of reports suppressed while the failed report was in flight are kept, so they are merged into
+     * the next report of the IP or returned by takePendingReports().
+     * 
+     * @param ipAddress The IP address to forget.
+     * @param now The current time.
+     */
+    void ReportSuppressor::forget(const string& ipAddress, const steady_clock::time_point now) {
+        forget(ipAddress, 0, now);
+    }
+
+    /**
+     * @brief Allows an IP to be reported again immediately, restoring the suppressed categories merged into the failed report.
+     * 
+     * @param ipAddress The IP address to forget.
+     * @param restoredCategories The categories tryReport() merged into the failed report.
+     * @param now The current time.
+     */
+    void ReportSuppressor::forget(const string& ipAddress, const uint64_t restoredCategories, const steady_clock::time_point now) {
+        lock_guard<mutex> lock(m_mutex);
+
+        auto entry = m_entries.find(ipAddress);
+        if (entry == m_entries.end()) {
+            if (restoredCategories == 0) { return; }
+
+            // kept outside of the wheel until the IP is reported again or collected by takePendingReports()
+            m_entries.emplace(ipAddress, Entry{ now - m_period, getTick(now), restoredCategories });
+            return;
+        }
+
+        entry->second.pendingCategories |= restoredCategories;
+
+        if (entry->second.pendingCategories == 0) {
+            m_entries.erase(entry);
+        } else {
+            entry->second.reportedAt = now - m_period;
+        }
+    }
+
+    /**
+     * @brief Removes the entries of all IPs which may be reported again and have suppressed categories pending.
+     * 
+     * Use this to periodically send the reports which were suppressed, but not followed by another report of the same IP.
+     * 
+     * @param now The current time.
+     * 
+     * @return The IP addresses and their pending categories.
+     */
+    vector<pair<string, uint64_t>> ReportSuppressor::takePendingReports(const steady_clock::time_point now) {
+        lock_guard<mutex> lock(m_mutex);
+
+        expire(getTick(now));
+
+        vector<pair<string, uint64_t>> pendingReports{};
+        for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+            if (entry->second.pendingCategories == 0 || now - entry->second.reportedAt < m_period) {
+                entry++;
+                continue;
+            }
+
+            pendingReports.emplace_back(entry->first, entry->second.pendingCategories);
+            entry = m_entries.erase(entry);
+        }
+
+        return pendingReports;
+    }
+
+    /**
+     * @brief Gets the amount of IPs currently in the table.
+     */
+    size_t ReportSuppressor::size() const {
+        lock_guard<mutex> lock(m_mutex);
+
+        return m_entries.size();
+    }
+
+    /**
+     * @brief Converts a point in time to a tick of the expiry wheel.
+     */
+    int64_t ReportSuppressor::getTick(const steady_clock::time_point time) const {
+        return duration_cast<seconds>(time.time_since_epoch()) / m_resolution;
+    }
+
+    /**
+     * @brief Advances the expiry wheel, removing all entries in the slots passed. Must be called with the mutex held.
+     * 
+     * Entries with pending categories are kept (outside of the wheel), so their categories are merged into the next report
+     * of the IP or returned by takePendingReports().
+     * 
+     * @param currentTick The current tick.
+     */
+    void ReportSuppressor::expire(const int64_t currentTick) {
+        // a slot is reused after m_wheel.size() ticks, which is always longer than the suppression period
+        const auto firstTick = std::max(m_lastTick + 1, currentTick - static_cast<int64_t>(m_wheel.size()) + 1);
+
+        for (auto tick = firstTick; tick <= currentTick; tick++) {
+            const auto expiredTick = tick - static_cast<int64_t>(m_wheel.size());
+            auto& slot = m_wheel[tick % m_wheel.size()];
+
+            for (const auto& ipAddress : slot) {
+                const auto entry = m_entries.find(ipAddress);
+
+                // the entry may have been re-inserted into a newer slot
+                if (entry != m_entries.end() && entry->second.tick <= expiredTick && entry->second.pendingCategories == 0) { m_entries.erase(entry); }
+            }
+
+            slot.clear();
+        }
+
+        m_lastTick = std::max(m_lastTick, currentTick);
+    }
+
+} /* namespace api */ } /* abuseipdb_client */
@@ -0,0 +1,140 @@
+/**
+ * @file SubnetReport.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the SubnetReport struct.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <string>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "api/SubnetReport.hpp"
+#include "util/Utilities.hpp"
+
+namespace abuseipdb_client { namespace api {
+
+    using std::string;
+
+    /**
+     * @brief Gets the netmask of a prefix length in host byte order.
+     */
+    static uint32_t getNetmask(const uint8_t prefixLength) {
+        return prefixLength == 0 ? 0 : ~uint32_t(0) << (32 - std::min<uint8_t>(prefixLength, 32));
+    }
+
+    /**
+     * @brief Checks whether an address lies within this subnet.
+     * 
+     * @param address The address in host byte order.
+     */
+    bool SubnetReport::contains(const uint32_t address) const {
+        return (address & getNetmask(prefixLength)) == (networkAddress & getNetmask(prefixLength));
+    }
+
+    /**
+     * @brief Finds a reported address.
+     * 
+     * @param address The address in host byte order.
+     * 
+     * @return const ReportedAddress* The reported address, or nullptr if the address wasn't reported.
+     */
+    const SubnetReport::ReportedAddress* SubnetReport::find(const uint32_t address) const {
+        const auto pos = std::lower_bound(reportedAddresses.begin(), reportedAddresses.end(), address, [](const ReportedAddress& x, const uint32_t y) {
+            return x.address < y;
+        });
+
+        return pos != reportedAddresses.end() && pos->address == address ? &*pos : nullptr;
+    }
+
+    /**
+     * @brief Answers a check of a single address within the subnet.
+     * Addresses which weren't reported are returned as a valid result with a score of zero.
+     * 
+     * @param address The address in host byte order.
+     * 
+     * @return CheckResult The result; invalid if the address isn't within the subnet.
+     */
+    CheckResult SubnetReport::getCheckResult(const uint32_t address) const {
+        CheckResult result{};
+        if (!contains(address)) { return result; }
+
+        result.isValid = true;
+        result.ipVersion = 4;
+        result.isPublic = true; // checkBlocked only accepts public ranges
+
+        const auto* reportedAddress = find(address);
+        if (!reportedAddress) { return result; }
+
+        result.abuseConfidenceScore = reportedAddress->abuseConfidenceScore;
+        result.totalReports = reportedAddress->numReports;
+        result.lastReportedAt = reportedAddress->mostRecentReport;
+        result.countryCode[0] = reportedAddress->countryCode[0];
+        result.countryCode[1] = reportedAddress->countryCode[1];
+
+        return result;
+    }
+
+    /**
+     * @brief Parses the response of the check-block endpoint.
+     * 
+     * @param response The response returned by AbuseIpDbApi::checkBlocked.
+     * @param result The output result.
+     * 
+     * @return true If the response contained a valid IPv4 subnet.
+     */
+    bool parseSubnetReport(const json& response, SubnetReport& result) {
+        result = SubnetReport();
+
+        if (!response.is_object() || !response.contains("data") || !response.at("data").is_object()) { return false; }
+
+        const auto& data = response.at("data");
+        uint32_t netmask = 0;
+
+        if (!utils::parseIpv4Address(data.value("networkAddress", string{}), result.networkAddress) ||
+            !utils::parseIpv4Address(data.value("netmask", string{}), netmask)) {
+            return false;
+        }
+
+        result.prefixLength = __builtin_popcount(netmask);
+
+        if (!data.contains("reportedAddress") || !data.at("reportedAddress").is_array()) { return true; }
+
+        for (const auto& reportedAddress : data.at("reportedAddress")) {
+            SubnetReport::ReportedAddress address{};
+
+            if (!utils::parseIpv4Address(reportedAddress.value("ipAddress", string{}), address.address)) { continue; }
+
+            address.numReports = reportedAddress.value("numReports", uint32_t(0));
+            address.abuseConfidenceScore = std::min(reportedAddress.value("abuseConfidenceScore", uint32_t(0)), uint32_t(100));
+
+            if (reportedAddress.contains("mostRecentReport") && reportedAddress.at("mostRecentReport").is_string()) {
+                utils::parseTimestamp(reportedAddress.at("mostRecentReport").get_ref<const string&>(), address.mostRecentReport);
+            }
+
+            if (reportedAddress.contains("countryCode") && reportedAddress.at("countryCode").is_string()) {
+                const auto& countryCode = reportedAddress.at("countryCode").get_ref<const string&>();
+                if (countryCode.size() == 2) {
+                    address.countryCode[0] = countryCode[0];
+                    address.countryCode[1] = countryCode[1];
+                }
+            }
+
+            result.reportedAddresses.push_back(address);
+        }
+
+        std::sort(result.reportedAddresses.begin(), result.reportedAddresses.end(), [](const auto& a, const auto& b) { return a.address < b.address; });
+
+        return true;
+    }
+
+} /* namespace api */ } /* abuseipdb_client */
@@ -0,0 +1,132 @@
+/**
+ * @file BlackList.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the BlackList class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+// C
+#include <arpa/inet.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/BlackList.hpp"
+#include "trace/TraceRecorder.hpp"
+#include "util/Utilities.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using std::make_shared;
+
+    /**
+     * @brief Constructs a new BlackList.
+     * 
+     * @param entries The entries; they will be sorted by address.
+     * @param generatedAt The time the list was generated by AbuseIPDB.
+     */
+    BlackList::BlackList(vector<Entry>&& entries, const time_t generatedAt): m_generatedAt(generatedAt), m_entries(std::move(entries)) {
+        std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) { return a.address < b.address; });
+    }
+
+    /**
+     * @brief Creates a blacklist from the response of AbuseIpDbApi::getBlackList.
+     * 
+     * @param response The response.
+     * 
+     * @return shared_ptr<const BlackList> The blacklist; nullptr if the response didn't contain a blacklist.
+     */
+    shared_ptr<const BlackList> BlackList::fromJson(const json& response) {
+        ABUSEIPDB_TRACE_SPAN("BlackList::fromJson", "parse");
+        if (!response.is_object() || !response.contains("data") || !response.at("data").is_array()) { return nullptr; }
+
+        time_t generatedAt = 0;
+        if (response.contains("meta") && response.at("meta").is_object()) {
+            utils::parseTimestamp(response.at("meta").value("generatedAt", string{}), generatedAt);
+        }
+
+        vector<Entry> entries{};
+        entries.reserve(response.at("data").size());
+
+        for (const auto& item : response.at("data")) {
+            Entry entry{};
+
+            if (!item.is_object() || !parseAddress(item.value("ipAddress", string{}), entry.address)) { continue; }
+
+            entry.abuseConfidenceScore = std::min(item.value("abuseConfidenceScore", uint32_t(0)), uint32_t(100));
+
+            if (item.contains("lastReportedAt") && item.at("lastReportedAt").is_string()) {
+                utils::parseTimestamp(item.at("lastReportedAt").get_ref<const string&>(), entry.lastReportedAt);
+            }
+
+            if (item.contains("countryCode") && item.at("countryCode").is_string()) {
+                const auto& countryCode = item.at("countryCode").get_ref<const string&>();
+                if (countryCode.size() == 2) {
+                    entry.countryCode[0] = countryCode[0];
+                    entry.countryCode[1] = countryCode[1];
+                }
+            }
+
+            entries.push_back(entry);
+        }
+
+        return make_shared<const BlackList>(std::move(entries), generatedAt);
+    }
+
+    /**
+     * @brief Parses an IPv4 or IPv6 address.
+     * 
+     * @param address The textual address.
+     * @param output The address; IPv4 addresses are IPv4-mapped.
+     * 
+     * @return true If the address is valid.
+     */
+    bool BlackList::parseAddress(const string& address, Address& output) {
+        output.fill(0);
+
+        if (inet_pton(AF_INET6, address.c_str(), output.data()) == 1) { return true; }
+
+        output[10] = 0xff;
+        output[11] = 0xff;
+        return inet_pton(AF_INET, address.c_str(), output.data() + 12) == 1;
+    }
+
+    /**
+     * @brief Looks up an address.
+     * 
+     * @param address The address.
+     * 
+     * @return const Entry* The entry, or nullptr if the address isn't blacklisted.
+     */
+    const BlackList::Entry* BlackList::find(const Address& address) const {
+        const auto pos = std::lower_bound(m_entries.begin(), m_entries.end(), address, [](const Entry& x, const Address& y) { return x.address < y; });
+
+        return pos != m_entries.end() && pos->address == address ? &*pos : nullptr;
+    }
+
+    /**
+     * @brief Looks up an address.
+     * 
+     * @param address The textual IPv4 or IPv6 address.
+     * 
+     * @return const Entry* The entry, or nullptr if the address isn't blacklisted or invalid.
+     */
+    const BlackList::Entry* BlackList::find(const string& address) const {
+        Address parsedAddress{};
+
+        return parseAddress(address, parsedAddress) ? find(parsedAddress) : nullptr;
+    }
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
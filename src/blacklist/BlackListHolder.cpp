@@ -0,0 +1,92 @@
+/**
+ * @file BlackListHolder.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the BlackListHolder class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <memory>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/BlackListHolder.hpp"
+#include "trace/TraceRecorder.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using std::make_shared;
+
+    /**
+     * @brief Creates a holder.
+     * 
+     * @param list The initial list. If not nullptr, it is published as the first generation.
+     */
+    BlackListHolder::BlackListHolder(shared_ptr<const BlackList> list):
+    m_snapshot(make_shared<const Snapshot>(Snapshot{ list, list ? 1u : 0u })) {}
+
+    /**
+     * @brief Publishes a new generation of the blacklist.
+     * 
+     * Readers holding a snapshot of the previous generation keep using it until they release it;
+     * the previous list is destroyed once the last of them has done so.
+     * Publications are expected from a single refresher; concurrent publishers may skip a generation number, but never lose a list.
+     * 
+     * @param list The new list.
+     * 
+     * @return uint64_t The new generation.
+     */
+    uint64_t BlackListHolder::publish(shared_ptr<const BlackList> list) {
+        ABUSEIPDB_TRACE_SPAN("BlackListHolder::publish", "cache");
+        auto current = m_snapshot.load(std::memory_order_acquire);
+        shared_ptr<const Snapshot> next{};
+
+        do {
+            next = make_shared<const Snapshot>(Snapshot{ list, current->generation + 1 });
+        } while (!m_snapshot.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        return next->generation;
+    }
+
+    /**
+     * @brief Parses the response of getBlackList and publishes it as a new generation.
+     * 
+     * Parsing happens before the publication, so readers keep using the current generation meanwhile.
+     * 
+     * @param response The response of getBlackList.
+     * 
+     * @return uint64_t The new generation, or 0 if the response couldn't be parsed (the current generation is kept).
+     */
+    uint64_t BlackListHolder::publish(const json& response) {
+        auto list = BlackList::fromJson(response);
+
+        return list ? publish(list) : 0;
+    }
+
+    /**
+     * @brief Looks up an address in the current generation.
+     * 
+     * @param address The textual IPv4 or IPv6 address.
+     * @param output The entry, copied out of the snapshot.
+     * 
+     * @return true If the current generation contains the address.
+     */
+    bool BlackListHolder::find(const string& address, BlackList::Entry& output) const {
+        const auto snapshot = getSnapshot();
+        if (!snapshot->list) { return false; }
+
+        const auto* entry = snapshot->list->find(address);
+        if (!entry) { return false; }
+
+        output = *entry;
+        return true;
+    }
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
@@ -0,0 +1,158 @@
+/**
+ * @file BlackListView.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the BlackListView class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <future>
+#include <memory>
+#include <string_view>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/BlackListView.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    using std::future;
+    using std::make_shared;
+    using std::string_view;
+
+    /**
+     * @brief Checks whether a country code is contained in a list of country codes.
+     */
+    static bool containsCountry(const vector<string>& countries, const string_view countryCode) {
+        return std::any_of(countries.begin(), countries.end(), [&](const string& x) { return x == countryCode; });
+    }
+
+    /**
+     * @brief Derives several views from the same list in parallel.
+     * 
+     * @param list The list to derive the views from.
+     * @param options The options of each view.
+     * 
+     * @return vector<shared_ptr<const BlackListView>> One view per options, in the same order.
+     */
+    vector<shared_ptr<const BlackListView>> BlackListView::createViews(shared_ptr<const BlackList> list, const vector<AbuseIpDbApi::BlackListOptions>& options) {
+        vector<future<shared_ptr<const BlackListView>>> futures{};
+        vector<shared_ptr<const BlackListView>> views{};
+
+        for (const auto& viewOptions : options) {
+            futures.push_back(std::async(std::launch::async, [&list, &viewOptions]() {
+                return shared_ptr<const BlackListView>(make_shared<const BlackListView>(list, viewOptions));
+            }));
+        }
+
+        for (auto& viewFuture : futures) { views.push_back(viewFuture.get()); }
+
+        return views;
+    }
+
+    /**
+     * @brief Gets the options of the broadest list, from which views with all of the passed options can be derived.
+     * 
+     * The broadest list holds the entries with the highest confidence of all countries, so the top entries of a single country
+     * may have been cut off by the limit. If any view filters by country, the limit is raised to the plan maximum.
+     * Even then, a country-filtered view may come up short if the list at the plan maximum is truncated
+     * (i.e. it contains maxLimit entries); fetch such views separately if they must be complete.
+     * 
+     * @param options The options of the views.
+     * @param maxLimit The max. no. of entries permitted by the subscription plan; see MAX_IPS_*.
+     * 
+     * @return AbuseIpDbApi::BlackListOptions The lowest confidence, the highest limit (or maxLimit, if any view filters by country) and no country filters.
+     */
+    AbuseIpDbApi::BlackListOptions BlackListView::getBroadestOptions(const vector<AbuseIpDbApi::BlackListOptions>& options, const size_t maxLimit) {
+        AbuseIpDbApi::BlackListOptions broadestOptions{};
+        if (options.empty()) { return broadestOptions; }
+
+        broadestOptions.limit = 0;
+        broadestOptions.minimumConfidence = 100;
+
+        for (const auto& viewOptions : options) {
+            broadestOptions.limit = std::max(broadestOptions.limit, viewOptions.limit);
+            broadestOptions.minimumConfidence = std::min(broadestOptions.minimumConfidence, viewOptions.minimumConfidence);
+
+            if (!viewOptions.onlyCountries.empty() || !viewOptions.exceptCountries.empty()) {
+                broadestOptions.limit = std::max(broadestOptions.limit, maxLimit);
+            }
+        }
+
+        return broadestOptions;
+    }
+
+    /**
+     * @brief Creates a view onto a list.
+     * 
+     * If more entries match than the limit allows, the entries with the highest confidence (and most recent reports) are kept,
+     * just as AbuseIPDB does.
+     * 
+     * @param list The list.
+     * @param options The filters to apply.
+     */
+    BlackListView::BlackListView(shared_ptr<const BlackList> list, const AbuseIpDbApi::BlackListOptions& options): m_list(list), m_indices({}) {
+        const auto& entries = m_list->getEntries();
+
+        for (uint32_t i = 0; i < entries.size(); i++) {
+            const auto& entry = entries[i];
+
+            if (entry.abuseConfidenceScore < options.minimumConfidence) { continue; }
+            if (!options.onlyCountries.empty() && !containsCountry(options.onlyCountries, entry.getCountryCode())) { continue; }
+            if (options.onlyCountries.empty() && containsCountry(options.exceptCountries, entry.getCountryCode())) { continue; }
+
+            m_indices.push_back(i);
+        }
+
+        if (m_indices.size() > options.limit) {
+            std::nth_element(m_indices.begin(), m_indices.begin() + options.limit, m_indices.end(), [&](const uint32_t a, const uint32_t b) {
+                return entries[a].abuseConfidenceScore != entries[b].abuseConfidenceScore ?
+                    entries[a].abuseConfidenceScore > entries[b].abuseConfidenceScore :
+                    entries[a].lastReportedAt > entries[b].lastReportedAt;
+            });
+
+            m_indices.resize(options.limit);
+            std::sort(m_indices.begin(), m_indices.end());
+        }
+
+        m_indices.shrink_to_fit();
+    }
+
+    /**
+     * @brief Looks up an address within the view.
+     * 
+     * @param address The address.
+     * 
+     * @return const BlackList::Entry* The entry, or nullptr if the address isn't contained in the view.
+     */
+    const BlackList::Entry* BlackListView::find(const Address& address) const {
+        const auto& entries = m_list->getEntries();
+        const auto pos = std::lower_bound(m_indices.begin(), m_indices.end(), address, [&](const uint32_t x, const Address& y) {
+            return entries[x].address < y;
+        });
+
+        return pos != m_indices.end() && entries[*pos].address == address ? &entries[*pos] : nullptr;
+    }
+
+    /**
+     * @brief Looks up an address within the view.
+     * 
+     * @param address The textual IPv4 or IPv6 address.
+     * 
+     * @return const BlackList::Entry* The entry, or nullptr if the address isn't contained in the view or invalid.
+     */
+    const BlackList::Entry* BlackListView::find(const string& address) const {
+        Address parsedAddress{};
+
+        return BlackList::parseAddress(address, parsedAddress) ? find(parsedAddress) : nullptr;
+    }
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
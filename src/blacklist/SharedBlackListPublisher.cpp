@@ -0,0 +1,214 @@
+/**
+ * @file SharedBlackListPublisher.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the SharedBlackListPublisher class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <type_traits>
+
+// C
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "blacklist/SharedBlackListPublisher.hpp"
+
+namespace abuseipdb_client { namespace blacklist {
+
+    namespace fs = std::filesystem;
+
+    using std::error_code;
+
+    static_assert(sizeof(BlackList::Entry) == sizeof(SharedBlackListEntry), "Blacklist entry layouts differ");
+    static_assert(offsetof(BlackList::Entry, lastReportedAt) == offsetof(SharedBlackListEntry, lastReportedAt), "Blacklist entry layouts differ");
+    static_assert(offsetof(BlackList::Entry, abuseConfidenceScore) == offsetof(SharedBlackListEntry, abuseConfidenceScore), "Blacklist entry layouts differ");
+    static_assert(offsetof(BlackList::Entry, countryCode) == offsetof(SharedBlackListEntry, countryCode), "Blacklist entry layouts differ");
+    static_assert(std::is_trivially_copyable_v<BlackList::Entry>, "Blacklist entries must be trivially copyable");
+
+    const size_t SharedBlackListPublisher::DEFAULT_CAPACITY = 1'000'000; //!< 32MiB; only the pages actually written are backed by memory
+
+    /**
+     * @brief Throws a filesystem_error containing the current errno.
+     */
+    [[noreturn]] static void throwSharedMemoryError(const string& message, const string& name) {
+        throw fs::filesystem_error(message, fs::path("/dev/shm") / fs::path(name).relative_path(), error_code(errno, std::system_category()));
+    }
+
+    /**
+     * @brief Marks a region as retired, so readers which have mapped it know to map its replacement.
+     * 
+     * Regions which aren't (compatible) shared blacklists are left untouched.
+     * 
+     * @param fd A read-write descriptor of the region.
+     * @param size The size of the region.
+     */
+    static void retireRegion(const int32_t fd, const size_t size) {
+        if (size < sizeof(SharedBlackListHeader)) { return; }
+
+        auto* mapping = mmap(nullptr, sizeof(SharedBlackListHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) { return; }
+
+        auto* header = static_cast<SharedBlackListHeader*>(mapping);
+        if (std::memcmp(header->magic, SHARED_BLACKLIST_MAGIC, sizeof(SHARED_BLACKLIST_MAGIC)) == 0 && header->version == SHARED_BLACKLIST_VERSION) {
+            header->isRetired.store(1, std::memory_order_release);
+        }
+
+        munmap(mapping, sizeof(SharedBlackListHeader));
+    }
+
+    /**
+     * @brief Removes the shared-memory region with the given name.
+     * 
+     * Processes which have mapped the region keep their mapping, but it is marked as retired,
+     * so readers switch to a new region as soon as one is created.
+     * 
+     * @param name The name of the region.
+     * 
+     * @return true If the region was removed.
+     */
+    bool SharedBlackListPublisher::unlink(const string& name) {
+        const auto fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd >= 0) {
+            struct stat regionStat{};
+            if (fstat(fd, &regionStat) == 0) { retireRegion(fd, regionStat.st_size); }
+            ::close(fd);
+        }
+
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+    /**
+     * @brief Creates or opens the shared-memory region and maps it.
+     * 
+     * An existing region with a compatible layout and capacity is reused, so consumers keep their mapping
+     * across restarts of the daemon; otherwise the region is recreated.
+     * 
+     * @param name The name of the region, e.g. "/abuseipdb-blacklist".
+     * @param logger The logger.
+     * @param capacity The max. no. of entries the region shall hold.
+     * 
+     * @throws fs::filesystem_error If the region cannot be created or mapped.
+     */
+    SharedBlackListPublisher::SharedBlackListPublisher(const string& name, shared_ptr<logger> logger, const size_t capacity):
+    m_entries(nullptr), m_header(nullptr), m_logger(logger), m_mappingSize(getSharedBlackListSize(capacity)), m_name(name) {
+        auto fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) { throwSharedMemoryError("Failed to open shared blacklist", name); }
+
+        struct stat regionStat{};
+        if (fstat(fd, &regionStat) != 0) {
+            ::close(fd);
+            throwSharedMemoryError("Failed to stat shared blacklist", name);
+        }
+
+        const auto isExisting = static_cast<size_t>(regionStat.st_size) == m_mappingSize;
+        if (!isExisting && regionStat.st_size != 0) {
+            m_logger->warn("Recreating shared blacklist {0:s} with a capacity of {1:d} entries", name, capacity);
+
+            retireRegion(fd, regionStat.st_size);
+            ::close(fd);
+            shm_unlink(name.c_str());
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+            if (fd < 0) { throwSharedMemoryError("Failed to recreate shared blacklist", name); }
+        }
+
+        if (!isExisting && ftruncate(fd, m_mappingSize) != 0) {
+            ::close(fd);
+            throwSharedMemoryError("Failed to size shared blacklist", name);
+        }
+
+        auto* mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) { throwSharedMemoryError("Failed to map shared blacklist", name); }
+
+        m_header = static_cast<SharedBlackListHeader*>(mapping);
+        m_entries = reinterpret_cast<SharedBlackListEntry*>(m_header + 1);
+
+        const auto isCompatible = std::memcmp(m_header->magic, SHARED_BLACKLIST_MAGIC, sizeof(SHARED_BLACKLIST_MAGIC)) == 0 &&
+                                  m_header->version == SHARED_BLACKLIST_VERSION && m_header->entrySize == sizeof(SharedBlackListEntry) &&
+                                  m_header->capacity == capacity;
+        if (isCompatible && !(m_header->sequence.load() & 1)) { return; }
+
+        // fresh region, or a publisher died while writing: start over with an empty list.
+        // the magic is written last, so readers never accept a half-initialised header.
+        std::memset(m_header->magic, 0, sizeof(m_header->magic));
+        m_header->version = SHARED_BLACKLIST_VERSION;
+        m_header->entrySize = sizeof(SharedBlackListEntry);
+        m_header->capacity = capacity;
+        m_header->generation.store(0);
+        m_header->generatedAt.store(0);
+        m_header->count.store(0);
+        m_header->isRetired.store(0);
+        m_header->sequence.store(isCompatible ? m_header->sequence.load() + 1 : 0, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(m_header->magic, SHARED_BLACKLIST_MAGIC, sizeof(SHARED_BLACKLIST_MAGIC));
+    }
+
+    /**
+     * @brief Unmaps the region; it remains available to consumers.
+     */
+    SharedBlackListPublisher::~SharedBlackListPublisher() {
+        if (m_header) { munmap(m_header, m_mappingSize); }
+    }
+
+    /**
+     * @brief Writes a list into the region.
+     * 
+     * Readers retry lookups which overlap the write, so they only ever see a complete list.
+     * 
+     * @param list The list to publish.
+     * @param generation The generation of the list.
+     * 
+     * @return true If the list was published, false if it exceeds the capacity of the region.
+     */
+    bool SharedBlackListPublisher::publish(const BlackList& list, const uint64_t generation) {
+        if (list.size() > m_header->capacity) {
+            m_logger->error("Cannot publish blacklist of {0:d} entries into shared blacklist {1:s} (capacity {2:d})", list.size(), m_name, m_header->capacity);
+            return false;
+        }
+
+        const auto sequence = m_header->sequence.load(std::memory_order_relaxed);
+        m_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(static_cast<void*>(m_entries), list.getEntries().data(), list.size() * sizeof(SharedBlackListEntry));
+        m_header->count.store(list.size(), std::memory_order_relaxed);
+        m_header->generatedAt.store(list.getGeneratedAt(), std::memory_order_relaxed);
+        m_header->generation.store(generation, std::memory_order_relaxed);
+
+        m_header->sequence.store(sequence + 2, std::memory_order_release);
+
+        SPDLOG_LOGGER_DEBUG(m_logger, "Published generation {0:d} ({1:d} entries) to shared blacklist {2:s}", generation, list.size(), m_name);
+        return true;
+    }
+
+    /**
+     * @brief Writes the current generation of a holder into the region.
+     * 
+     * @param holder The holder.
+     * 
+     * @return true If a list was published; false if the holder is empty or its list exceeds the capacity.
+     */
+    bool SharedBlackListPublisher::publish(const BlackListHolder& holder) {
+        const auto snapshot = holder.getSnapshot();
+
+        return snapshot->list && publish(*snapshot->list, snapshot->generation);
+    }
+
+} /* namespace blacklist */ } /* namespace abuseipdb_client */
@@ -0,0 +1,206 @@
+/**
+ * @file Config.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the deserialisation and validation of the Config struct.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+// spdlog
+#include <spdlog/spdlog.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "cfg/Config.hpp"
+#include "cfg/ConfigManager.hpp"
+#include "resources/Resources.hpp"
+
+namespace abuseipdb_client { namespace cfg {
+
+    using spdlog::fmt_lib::format;
+
+    using std::make_shared;
+    using std::vector;
+
+    /**
+     * @brief Reads a single value from the merged config, recording an error if it has the wrong type or is out of range.
+     * 
+     * @param config The merged config.
+     * @param path The dotted path of the value.
+     * @param output The value.
+     * @param errors The list of validation errors.
+     * @param minValue The minimum permitted value (numbers only).
+     * @param maxValue The maximum permitted value (numbers only).
+     */
+    template<class T>
+    static void readValue(const json& config, const string& path, T& output, vector<string>& errors, const int64_t minValue = 0, const int64_t maxValue = INT64_MAX) {
+        const auto pointer = ConfigManager::compilePath(path);
+
+        if (!config.contains(pointer)) {
+            errors.push_back(format("{:s}: missing", path));
+            return;
+        }
+
+        const auto& value = config.at(pointer);
+
+        if constexpr (std::is_same_v<T, bool>) {
+            if (!value.is_boolean()) { errors.push_back(format("{:s}: expected true or false", path)); return; }
+            output = value.get<bool>();
+        } else if constexpr (std::is_same_v<T, string>) {
+            if (!value.is_string()) { errors.push_back(format("{:s}: expected a string", path)); return; }
+            output = value.get<string>();
+        } else if constexpr (std::is_same_v<T, seconds>) {
+            if (!value.is_number_integer()) { errors.push_back(format("{:s}: expected an integer (seconds)", path)); return; }
+            if (value.get<int64_t>() < minValue || value.get<int64_t>() > maxValue) {
+                errors.push_back(format("{:s}: must be between {:d} and {:d}", path, minValue, maxValue));
+                return;
+            }
+            output = seconds(value.get<int64_t>());
+        } else {
+            static_assert(std::is_integral_v<T>, "Unsupported config type");
+
+            if (!value.is_number_integer()) { errors.push_back(format("{:s}: expected an integer", path)); return; }
+            if (value.get<int64_t>() < minValue || value.get<int64_t>() > maxValue) {
+                errors.push_back(format("{:s}: must be between {:d} and {:d}", path, minValue, maxValue));
+                return;
+            }
+            output = static_cast<T>(value.get<int64_t>());
+        }
+    }
+
+    /**
+     * @brief Gets the embedded default config, parsed once.
+     * 
+     * Only required to merge a config file over the defaults; falling back to the defaults uses getDefaultConfig().
+     * 
+     * @return const json& The default config.
+     */
+    const json& Config::getDefaults() {
+        const static json defaults = json::parse(resources::getDefaultConfig());
+
+        return defaults;
+    }
+
+    /**
+     * @brief Gets the default config.
+     * 
+     * The values were extracted from cfg/config.json and type-checked at configure time, so no parsing is required.
+     * 
+     * @return shared_ptr<const Config> The default config.
+     */
+    shared_ptr<const Config> Config::getDefaultConfig() {
+        constexpr auto values = resources::getDefaultConfigValues();
+
+        static_assert(values.wakeupTimeSeconds >= 1, "WakeupTimeSeconds must be at least 1");
+        static_assert(values.aggregationWindowSeconds >= 0, "AggregationWindowSeconds must not be negative");
+        static_assert(values.mqttBrokerPort >= 1 && values.mqttBrokerPort <= UINT16_MAX, "BrokerPort must be a valid port");
+
+        const static auto defaultConfig = make_shared<const Config>(Config{
+            values.runAsDaemon,
+            seconds(values.wakeupTimeSeconds),
+            AbuseIpDbConfig{ string(values.abuseIpDbApiKey) },
+            ReportingConfig{ seconds(values.aggregationWindowSeconds) },
+            Fail2BanConfig{ values.fail2BanEnabled, string(values.fail2BanDbFile) },
+            EndlesshConfig{ values.endlesshEnabled, values.useEndlesshReport },
+            MqttConfig{ string(values.mqttBrokerAddress), static_cast<uint16_t>(values.mqttBrokerPort), string(values.mqttUsername), string(values.mqttPassword) }
+        });
+
+        return defaultConfig;
+    }
+
+    /**
+     * @brief Serialises the config in the layout of config.json.
+     * 
+     * @return json The config.
+     */
+    json Config::toJson() const {
+        return json{
+            { "RunAsDaemon", runAsDaemon },
+            { "WakeupTimeSeconds", wakeupTime.count() },
+            { "AbuseIpDb", { { "ApiKey", abuseIpDb.apiKey } } },
+            { "Reporting", { { "AggregationWindowSeconds", reporting.aggregationWindow.count() } } },
+            { "Fail2Ban", { { "Enabled", fail2Ban.isEnabled }, { "DbFile", fail2Ban.dbFile } } },
+            { "Endlessh", { { "Enabled", endlessh.isEnabled }, { "UseEndlesshReport", endlessh.useEndlesshReport } } },
+            { "Mqtt", {
+                { "BrokerAddress", mqtt.brokerAddress },
+                { "BrokerPort", mqtt.brokerPort },
+                { "Username", mqtt.username },
+                { "Password", mqtt.password }
+            } }
+        };
+    }
+
+    /**
+     * @brief Deserialises and validates a config.
+     * 
+     * The config is merged over the embedded defaults, so only the values which differ need to be set.
+     * Values which aren't part of the known schema are ignored.
+     * 
+     * @param config The parsed config file.
+     * 
+     * @return shared_ptr<const Config> The immutable config.
+     * 
+     * @throws ConfigException If any value has the wrong type or is out of range. The message lists all errors.
+     */
+    shared_ptr<const Config> Config::fromJson(const json& config) {
+        if (!config.is_object()) {
+            throw ConfigException("<root>", "Config must be a JSON object!");
+        }
+
+        auto merged = getDefaults();
+        merged.merge_patch(config);
+
+        auto output = make_shared<Config>();
+        vector<string> errors{};
+
+        readValue(merged, "RunAsDaemon", output->runAsDaemon, errors);
+        readValue(merged, "WakeupTimeSeconds", output->wakeupTime, errors, 1, 86'400);
+
+        readValue(merged, "AbuseIpDb.ApiKey", output->abuseIpDb.apiKey, errors);
+
+        readValue(merged, "Reporting.AggregationWindowSeconds", output->reporting.aggregationWindow, errors, 0, 900);
+
+        readValue(merged, "Fail2Ban.Enabled", output->fail2Ban.isEnabled, errors);
+        readValue(merged, "Fail2Ban.DbFile", output->fail2Ban.dbFile, errors);
+
+        readValue(merged, "Endlessh.Enabled", output->endlessh.isEnabled, errors);
+        readValue(merged, "Endlessh.UseEndlesshReport", output->endlessh.useEndlesshReport, errors);
+
+        readValue(merged, "Mqtt.BrokerAddress", output->mqtt.brokerAddress, errors);
+        readValue(merged, "Mqtt.BrokerPort", output->mqtt.brokerPort, errors, 1, UINT16_MAX);
+        readValue(merged, "Mqtt.Username", output->mqtt.username, errors);
+        readValue(merged, "Mqtt.Password", output->mqtt.password, errors);
+
+        if (output->fail2Ban.isEnabled && output->fail2Ban.dbFile.empty()) {
+            errors.push_back("Fail2Ban.DbFile: required when Fail2Ban is enabled");
+        }
+
+        if (!errors.empty()) {
+            throw ConfigException(
+                "<root>",
+                format("{:d} invalid value(s): {:s}", errors.size(), std::accumulate(
+                    std::next(errors.begin()), errors.end(), errors.front(), [](string a, const string& b) { return std::move(a) + "; " + b; }
+                ))
+            );
+        }
+
+        return output;
+    }
+
+} /* namespace cfg */ } /* namespace abuseipdb_client */
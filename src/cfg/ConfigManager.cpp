@@ -12,9 +12,19 @@
 //  SYSTEM INCLUDES  //
 ///////////////////////
 // stl
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+// C
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 
 // json
 #include <nlohmann/json.hpp>
@@ -23,7 +33,7 @@
 //  LOCAL  INCLUDES  //
 ///////////////////////
 #include "cfg/ConfigManager.hpp"
-#include "resources/Resources.hpp"
+#include "trace/TraceRecorder.hpp"
 #include "util/Utilities.hpp"
 
 namespace abuseipdb_client { namespace cfg {
@@ -32,9 +42,15 @@ namespace abuseipdb_client { namespace cfg {
 
     using spdlog::fmt_lib::format;
 
+    using std::chrono::milliseconds;
     using std::error_code;
     using std::exception;
+    using std::lock_guard;
+    using std::make_shared;
+    using std::shared_lock;
     using std::string;
+    using std::unique_lock;
+    using std::vector;
 
     namespace fs = std::filesystem;
 
@@ -47,6 +63,9 @@ namespace abuseipdb_client { namespace cfg {
     #endif
     const string ConfigManager::CONFIG_PATTERN = R"(([A-z0-9_-]+\.?)+)";
 
+    const static milliseconds CONFIG_WATCH_POLL_INTERVAL = milliseconds(250); //!< How often the watch thread checks whether it shall stop
+    const static milliseconds CONFIG_WATCH_DEBOUNCE = milliseconds(100); //!< Editors often emit several events per save; wait for them to settle
+
     /**
      * @brief Gets the current instance or returns a new instance of ConfigManager.
      * 
@@ -62,40 +81,281 @@ namespace abuseipdb_client { namespace cfg {
         return instance;
     }
 
-    ConfigManager::ConfigManager(): m_logger(nullptr), m_cfgPath(DEFAULT_CONFIG_LOCATION) {}
+    ConfigManager::ConfigManager():
+    m_isWatching(false), m_state(make_shared<const ConfigState>()), m_logger(nullptr),
+    m_nextListenerId(0), m_cfgPath(DEFAULT_CONFIG_LOCATION) {}
+
+    /**
+     * @brief Compiles a dotted config path into a JSON pointer, which can be resolved without allocating.
+     * 
+     * @param path The dotted path, e.g. "Fail2Ban.DbFile".
+     * 
+     * @return json::json_pointer The equivalent JSON pointer, e.g. "/Fail2Ban/DbFile".
+     * 
+     * @throws ConfigException If the path is malformed.
+     */
+    json::json_pointer ConfigManager::compilePath(const string_view path) {
+        if (path.empty() || !utils::regexMatch(string(path), CONFIG_PATTERN)) {
+            throw ConfigException(string(path), "Invalid config path!");
+        }
+
+        string pointer{};
+        for (const auto segment : utils::splitView(path, ".")) { pointer.append("/").append(segment); }
 
-    bool ConfigManager::hasConfig(const string& config) const { return hasConfig(m_configObj, config); }
+        return json::json_pointer(pointer);
+    }
 
-    bool ConfigManager::hasConfig(const json& container, const string& path) const {
-        if (utils::regexMatch(path, CONFIG_PATTERN)) {
-            const auto tokens = utils::splitString(path, ".");
-            return hasConfig(tokens.front()) ?
-                hasConfig(m_configObj.at(tokens.front()), utils::replaceString(const_cast<string&>(path), tokens.front() + ".", ""))
-                : false;
+    /**
+     * @brief Checks whether a config exists.
+     * 
+     * @param config The dotted path of the config.
+     * 
+     * @return false If the config doesn't exist or the path is malformed.
+     */
+    bool ConfigManager::hasConfig(const string_view config) const {
+        try {
+            return hasConfig(m_state.load(std::memory_order_acquire)->configObj, getCompiledPath(config));
+        } catch (const ConfigException&) {
+            return false;
         }
+    }
+
+    bool ConfigManager::hasConfig(const json::json_pointer& config) const { return hasConfig(m_state.load(std::memory_order_acquire)->configObj, config); }
+
+    /**
+     * @brief Gets the compiled form of a dotted config path.
+     * 
+     * Each path is compiled once; later lookups only hash the path and don't allocate.
+     * 
+     * @param path The dotted path.
+     * 
+     * @return const json::json_pointer& The compiled path. Remains valid for the lifetime of this object.
+     */
+    const json::json_pointer& ConfigManager::getCompiledPath(const string_view path) const {
+        {
+            shared_lock<shared_mutex> lock(m_pathCacheMutex);
+
+            const auto pos = m_pathCache.find(path);
+            if (pos != m_pathCache.end()) { return pos->second; }
+        }
+
+        auto compiledPath = compilePath(path);
 
+        unique_lock<shared_mutex> lock(m_pathCacheMutex);
+        return m_pathCache.try_emplace(string(path), std::move(compiledPath)).first->second;
+    }
+
+    bool ConfigManager::hasConfig(const json& container, const json::json_pointer& path) const {
         return container.contains(path);
     }
 
+    /**
+     * @brief Loads the config file and deserialises it into a typed Config.
+     * 
+     * If the config file cannot be read, the defaults embedded at compile time are loaded.
+     * 
+     * @throws ConfigException If the config cannot be parsed or contains invalid values.
+     */
     void ConfigManager::loadConfigs() {
+        ABUSEIPDB_TRACE_SPAN("ConfigManager::loadConfigs", "config");
         error_code err;
 
         string configString;
 
         if (!fs::exists(m_cfgPath, err) || !fs::is_regular_file(m_cfgPath, err) || !utils::readFile(m_cfgPath, configString)) {
             m_logger->error("Couldn't open config file. Does it exist? Will load defaults! Some features may not work as expected!");
-            m_logger->error("This information might help: {:s}", err.value());
-            configString = resources::getDefaultConfig();
+            m_logger->error("This information might help: {:s}", err.message());
+
+            // the defaults were validated at build time; the JSON is what a config file without any values would publish
+            const auto defaultConfig = Config::getDefaultConfig();
+            m_state.store(make_shared<const ConfigState>(ConfigState{ defaultConfig, defaultConfig->toJson() }), std::memory_order_release);
+        } else {
+            try {
+                publishConfig(configString, m_cfgPath);
+            } catch (const ConfigException& ex) {
+                m_logger->critical("Invalid configuration! {:s}", ex.what());
+                throw;
+            }
         }
 
+        if (getSnapshot()->abuseIpDb.apiKey.empty()) {
+            m_logger->warn("No API key configured (AbuseIpDb.ApiKey); requests to AbuseIPDB will fail!");
+        }
+    }
+
+    /**
+     * @brief Starts a thread which reloads the config whenever the config file is written or replaced.
+     * 
+     * The parent directory is watched rather than the file itself, so configs which are replaced by renaming
+     * (as most editors and configuration management tools do) are picked up as well.
+     * Invalid configs are rejected and the current config is kept.
+     * The thread watches the config path set at the time it was started.
+     */
+    void ConfigManager::startWatching() {
+        if (m_isWatching) { return; }
+        if (m_watchThread.joinable()) { m_watchThread.join(); }
+
+        m_isWatching = true;
+        m_watchThread = thread(&ConfigManager::watchConfigFile, this, m_cfgPath);
+    }
+
+    /**
+     * @brief Stops watching the config file.
+     */
+    void ConfigManager::stopWatching() {
+        m_isWatching = false;
+
+        if (m_watchThread.joinable()) { m_watchThread.join(); }
+    }
+
+    /**
+     * @brief Registers a callback which is invoked (on the watch thread) with each reloaded config.
+     * 
+     * @param listener The callback.
+     * 
+     * @return size_t The ID of the listener, for removeListener.
+     */
+    size_t ConfigManager::addListener(ConfigListener listener) {
+        lock_guard<mutex> lock(m_listenerMutex);
+
+        m_listeners.emplace(m_nextListenerId, listener);
+        return m_nextListenerId++;
+    }
+
+    /**
+     * @brief Removes a callback registered with addListener.
+     * 
+     * @param listenerId The ID of the listener.
+     */
+    void ConfigManager::removeListener(const size_t listenerId) {
+        lock_guard<mutex> lock(m_listenerMutex);
+
+        m_listeners.erase(listenerId);
+    }
+
+    /**
+     * @brief Parses and validates a config and, if it is valid, atomically publishes it.
+     * 
+     * Readers holding a previous snapshot keep using it; new lookups see the new config.
+     * The typed config and its JSON are published as a single state, so readers never see one without the other.
+     * The JSON is merged over the defaults just like the typed config, so both agree on values the file omits.
+     * 
+     * @param configString The contents of the config file.
+     * @param configPath The path the config was read from.
+     * 
+     * @throws ConfigException If the config cannot be parsed or contains invalid values. Nothing is published in that case.
+     */
+    void ConfigManager::publishConfig(const string& configString, const string& configPath) {
+        json configObj{};
+
         try {
-            m_configObj = json::parse(configString, nullptr, true, true);
+            configObj = json::parse(configString, nullptr, true, true);
         } catch (const exception& ex) {
-            m_logger->critical("Failed to parse configuration! Error: {:s}", ex.what());
-            m_logger->critical("Some or all application functions may be impaired!");
+            throw ConfigException(configPath, format("Failed to parse configuration! Error: {:s}", ex.what()));
         }
+
+        auto config = Config::fromJson(configObj);
+
+        auto mergedObj = Config::getDefaults();
+        mergedObj.merge_patch(configObj);
+
+        m_state.store(make_shared<const ConfigState>(ConfigState{ config, std::move(mergedObj) }), std::memory_order_release);
     }
 
+    /**
+     * @brief Reloads the config file and notifies the listeners.
+     * 
+     * Unlike loadConfigs, this never falls back to the defaults and never throws:
+     * if the file cannot be read or is invalid, the current config is kept.
+     * 
+     * @param configPath The path of the config file.
+     * 
+     * @return true If a new config was published.
+     */
+    bool ConfigManager::reloadConfigs(const string& configPath) {
+        ABUSEIPDB_TRACE_SPAN("ConfigManager::reloadConfigs", "config");
+        string configString;
+
+        if (!utils::readFile(configPath, configString)) {
+            m_logger->warn("Couldn't read config file {:s}; keeping the current configuration", configPath);
+            return false;
+        }
 
+        try {
+            publishConfig(configString, configPath);
+        } catch (const ConfigException& ex) {
+            m_logger->error("Rejected reloaded configuration, keeping the current one: {:s}", ex.what());
+            return false;
+        }
+
+        m_logger->info("Reloaded configuration from {:s}", configPath);
+
+        vector<ConfigListener> listeners{};
+        {
+            lock_guard<mutex> lock(m_listenerMutex);
+            for (const auto& listener : m_listeners) { listeners.push_back(listener.second); }
+        }
+
+        const auto config = getSnapshot();
+        for (const auto& listener : listeners) { listener(config); }
+
+        return true;
+    }
+
+    /**
+     * @brief The body of the watch thread.
+     * 
+     * @param configPath The path of the config file; a copy, as setConfigPath may be called while watching.
+     */
+    void ConfigManager::watchConfigFile(const string configPath) {
+        const auto directory = fs::path(configPath).has_parent_path() ? fs::path(configPath).parent_path() : fs::path(".");
+        const auto fileName = fs::path(configPath).filename().string();
+
+        const auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            m_logger->error("Failed to initialise inotify: {:s}", std::strerror(errno));
+            m_isWatching = false;
+            return;
+        }
+
+        if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            m_logger->error("Failed to watch {:s}: {:s}", directory.string(), std::strerror(errno));
+            close(fd);
+            m_isWatching = false;
+            return;
+        }
+
+        alignas(inotify_event) char eventBuffer[4096];
+
+        // reads all pending events; returns true if any of them concern the config file
+        const auto readEvents = [&]() {
+            bool isConfigChanged = false;
+
+            for (ssize_t length = 0; (length = read(fd, eventBuffer, sizeof(eventBuffer))) > 0;) {
+                for (char* ptr = eventBuffer; ptr < eventBuffer + length;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                    if (event->len > 0 && fileName == event->name) { isConfigChanged = true; }
+
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+
+            return isConfigChanged;
+        };
+
+        SPDLOG_LOGGER_DEBUG(m_logger, "Watching {:s} for changes", configPath);
+
+        while (m_isWatching) {
+            pollfd pollFd{ fd, POLLIN, 0 };
+            if (poll(&pollFd, 1, CONFIG_WATCH_POLL_INTERVAL.count()) <= 0 || !readEvents()) { continue; }
+
+            std::this_thread::sleep_for(CONFIG_WATCH_DEBOUNCE);
+            readEvents();
+
+            reloadConfigs(configPath);
+        }
+
+        close(fd);
+    }
 
 } /* namespace cfg */ } /* namespace abuseipdb_client */
\ No newline at end of file
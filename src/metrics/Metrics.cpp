@@ -0,0 +1,199 @@
+/**
+ * @file Metrics.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the Counter, Gauge and Histogram metrics.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "metrics/Metrics.hpp"
+
+namespace abuseipdb_client { namespace metrics {
+
+    using std::memory_order_relaxed;
+
+    /**
+     * @brief Gets the shard the calling thread should write to.
+     *
+     * Threads are assigned a shard round-robin when they first record a value, so concurrent writers
+     * rarely share a cache line.
+     *
+     * @return The shard index, in the range [0, SHARD_COUNT).
+     */
+    size_t getShardIndex() {
+        static atomic<size_t> nextShard{0};
+        thread_local const size_t shard = nextShard.fetch_add(1, memory_order_relaxed) % SHARD_COUNT;
+
+        return shard;
+    }
+
+    /**
+     * @brief Adds a value to the counter.
+     *
+     * @param value The value to add.
+     */
+    void Counter::increment(const uint64_t value) {
+        m_shards[getShardIndex()].value.fetch_add(value, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the current value of the counter.
+     *
+     * @return The sum of all shards.
+     */
+    uint64_t Counter::get() const {
+        uint64_t total = 0;
+        for (const auto& shard : m_shards) { total += shard.value.load(memory_order_relaxed); }
+
+        return total;
+    }
+
+    /**
+     * @brief Gets the bucket a value falls into.
+     *
+     * @param micros The value in microseconds.
+     *
+     * @return The index of the bucket.
+     */
+    size_t Histogram::getBucketIndex(const uint64_t micros) {
+        if (micros < SUB_BUCKET_COUNT) { return micros; }
+
+        const uint32_t magnitude = std::bit_width(micros) - 1 - SUB_BUCKET_BITS;
+        const uint64_t subBucket = (micros >> magnitude) & (SUB_BUCKET_COUNT - 1);
+
+        return SUB_BUCKET_COUNT + magnitude * SUB_BUCKET_COUNT + subBucket;
+    }
+
+    /**
+     * @brief Gets the smallest value counted by a bucket.
+     *
+     * @param index The index of the bucket.
+     *
+     * @return The lower bound in microseconds.
+     */
+    uint64_t Histogram::getBucketLowerBound(const size_t index) {
+        if (index < SUB_BUCKET_COUNT) { return index; }
+
+        const uint64_t magnitude = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_COUNT;
+        const uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+
+        return (SUB_BUCKET_COUNT + subBucket) << magnitude;
+    }
+
+    /**
+     * @brief Gets the first value which is no longer counted by a bucket.
+     *
+     * @param index The index of the bucket.
+     *
+     * @return The exclusive upper bound in microseconds. Saturates for the last bucket.
+     */
+    uint64_t Histogram::getBucketUpperBound(const size_t index) {
+        if (index < SUB_BUCKET_COUNT) { return index + 1; }
+        if (index + 1 >= BUCKET_COUNT) { return UINT64_MAX; }
+
+        return getBucketLowerBound(index + 1);
+    }
+
+    /**
+     * @brief Records a duration.
+     *
+     * @param seconds The duration in seconds. Negative values are recorded as zero.
+     */
+    void Histogram::observe(const double seconds) {
+        observeMicros(seconds > 0 ? static_cast<uint64_t>(std::llround(seconds * 1'000'000)) : 0);
+    }
+
+    /**
+     * @brief Records a duration.
+     *
+     * @param micros The duration in microseconds.
+     */
+    void Histogram::observeMicros(const uint64_t micros) {
+        m_buckets[getBucketIndex(micros)].fetch_add(1, memory_order_relaxed);
+
+        auto& shard = m_shards[getShardIndex()];
+        shard.count.fetch_add(1, memory_order_relaxed);
+        shard.sum.fetch_add(micros, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the amount of recorded values.
+     */
+    uint64_t Histogram::getCount() const {
+        uint64_t total = 0;
+        for (const auto& shard : m_shards) { total += shard.count.load(memory_order_relaxed); }
+
+        return total;
+    }
+
+    /**
+     * @brief Gets the amount of recorded values which are known to be less than or equal to a value.
+     *
+     * Only buckets which lie entirely at or below the value are counted, so the result is accurate to the
+     * resolution of the histogram.
+     *
+     * @param micros The upper bound in microseconds.
+     *
+     * @return The cumulative count.
+     */
+    uint64_t Histogram::getCountAtOrBelow(const uint64_t micros) const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT && getBucketUpperBound(i) - 1 <= micros; i++) {
+            total += m_buckets[i].load(memory_order_relaxed);
+        }
+
+        return total;
+    }
+
+    /**
+     * @brief Gets a percentile of the recorded values.
+     *
+     * @param percentile The percentile to get, in the range [0, 100].
+     *
+     * @return The highest value equivalent to the percentile, in microseconds. Zero if nothing was recorded.
+     */
+    uint64_t Histogram::getPercentile(const double percentile) const {
+        array<uint64_t, BUCKET_COUNT> counts{};
+        uint64_t total = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            counts[i] = m_buckets[i].load(memory_order_relaxed);
+            total += counts[i];
+        }
+
+        if (total == 0) { return 0; }
+
+        const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen >= rank) { return getBucketUpperBound(i) - 1; }
+        }
+
+        return UINT64_MAX;
+    }
+
+    /**
+     * @brief Gets the sum of all recorded values in microseconds.
+     */
+    uint64_t Histogram::getSumMicros() const {
+        uint64_t total = 0;
+        for (const auto& shard : m_shards) { total += shard.sum.load(memory_order_relaxed); }
+
+        return total;
+    }
+
+} /* namespace metrics */ } /* namespace abuseipdb_client */
@@ -0,0 +1,323 @@
+/**
+ * @file MetricsRegistry.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the MetricsRegistry class.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+// C
+#include <fcntl.h>
+#include <unistd.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "metrics/MetricsRegistry.hpp"
+
+namespace abuseipdb_client { namespace metrics {
+
+    using std::lock_guard;
+    using std::make_shared;
+    using std::shared_lock;
+    using std::unique_lock;
+
+    const vector<double> MetricsRegistry::DEFAULT_LATENCY_BOUNDS = {
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60
+    }; //!< 1ms - 60s; AbuseIPDB requests usually take tens to hundreds of milliseconds
+
+    /**
+     * @brief Formats a sample value in the shortest form which round-trips.
+     *
+     * @param value The value to format.
+     *
+     * @return The formatted value.
+     */
+    static string formatValue(const double value) {
+        if (std::isnan(value)) { return "NaN"; }
+        if (std::isinf(value)) { return value > 0 ? "+Inf" : "-Inf"; }
+
+        char buffer[32]{};
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+        return string(buffer, result.ptr);
+    }
+
+    /**
+     * @brief Appends the HELP and TYPE lines of a family.
+     */
+    static void appendHeader(string& output, const string& name, const string& help, const char* type) {
+        output.append("# HELP ").append(name).append(" ").append(help).append("\n");
+        output.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+    }
+
+    /**
+     * @brief Adds a label to already formatted labels.
+     *
+     * @param labels The formatted labels, including braces. May be empty.
+     * @param label The formatted label to add, without braces.
+     *
+     * @return The combined labels.
+     */
+    static string appendLabel(const string& labels, const string& label) {
+        if (labels.empty()) { return "{" + label + "}"; }
+
+        return labels.substr(0, labels.size() - 1) + "," + label + "}";
+    }
+
+    /**
+     * @brief Stops the textfile writer, if it is running.
+     */
+    MetricsRegistry::~MetricsRegistry() { stopTextfileWriter(); }
+
+    /**
+     * @brief Escapes a label value as required by the Prometheus text format.
+     *
+     * @param value The raw value.
+     *
+     * @return The value with backslashes, double quotes and newlines escaped.
+     */
+    string MetricsRegistry::escapeLabelValue(const string& value) {
+        string escaped;
+        escaped.reserve(value.size());
+
+        for (const auto c : value) {
+            switch (c) {
+                case '\\': escaped += "\\\\"; break;
+                case '"': escaped += "\\\""; break;
+                case '\n': escaped += "\\n"; break;
+                default: escaped += c; break;
+            }
+        }
+
+        return escaped;
+    }
+
+    /**
+     * @brief Formats a set of labels.
+     *
+     * @param labels The labels to format.
+     *
+     * @return The labels in the form {name="value",...}, or an empty string if there are no labels.
+     */
+    string MetricsRegistry::formatLabels(const Labels& labels) {
+        if (labels.empty()) { return string(); }
+
+        string formatted = "{";
+        for (const auto& label : labels) {
+            if (formatted.size() > 1) { formatted += ","; }
+            formatted.append(label.first).append("=\"").append(escapeLabelValue(label.second)).append("\"");
+        }
+
+        return formatted + "}";
+    }
+
+    /**
+     * @brief Gets or creates a counter.
+     *
+     * @param name The name of the metric family. Should end in _total.
+     * @param help The description of the family. Only used when the family is created.
+     * @param labels The labels of the series.
+     *
+     * @return The counter, which remains valid for as long as the caller holds it.
+     */
+    shared_ptr<Counter> MetricsRegistry::getCounter(const string& name, const string& help, const Labels& labels) {
+        return getMetric(m_counters, name, help, labels);
+    }
+
+    /**
+     * @brief Gets or creates a gauge.
+     *
+     * @param name The name of the metric family.
+     * @param help The description of the family. Only used when the family is created.
+     * @param labels The labels of the series.
+     *
+     * @return The gauge, which remains valid for as long as the caller holds it.
+     */
+    shared_ptr<Gauge> MetricsRegistry::getGauge(const string& name, const string& help, const Labels& labels) {
+        return getMetric(m_gauges, name, help, labels);
+    }
+
+    /**
+     * @brief Gets or creates a latency histogram.
+     *
+     * @param name The name of the metric family. Should end in _seconds.
+     * @param help The description of the family. Only used when the family is created.
+     * @param labels The labels of the series. Must not contain "le".
+     *
+     * @return The histogram, which remains valid for as long as the caller holds it.
+     */
+    shared_ptr<Histogram> MetricsRegistry::getHistogram(const string& name, const string& help, const Labels& labels) {
+        return getMetric(m_histograms, name, help, labels);
+    }
+
+    /**
+     * @brief Writes all metrics to a file for node_exporter's textfile collector.
+     *
+     * The file is written to a temporary file first and then renamed, so the collector never sees a partial file.
+     *
+     * @param path The path of the file to write. Should end in .prom.
+     *
+     * @return true If the file was written.
+     */
+    bool MetricsRegistry::writeTextfile(const string& path) const {
+        const auto contents = serialise();
+        const auto tmpPath = path + ".tmp";
+
+        const auto fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) { return false; }
+
+        size_t written = 0;
+        while (written < contents.size()) {
+            const auto result = write(fd, contents.data() + written, contents.size() - written);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result <= 0) { break; }
+
+            written += static_cast<size_t>(result);
+        }
+        close(fd);
+
+        if (written != contents.size() || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            unlink(tmpPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Serialises all metrics in the Prometheus text exposition format.
+     *
+     * @return The serialised metrics.
+     */
+    string MetricsRegistry::serialise() const {
+        string output;
+        shared_lock<shared_mutex> lock(m_mutex);
+
+        for (const auto& [name, family] : m_counters) {
+            appendHeader(output, name, family.help, "counter");
+            for (const auto& [labels, counter] : family.series) {
+                output.append(name).append(labels).append(" ").append(std::to_string(counter->get())).append("\n");
+            }
+        }
+
+        for (const auto& [name, family] : m_gauges) {
+            appendHeader(output, name, family.help, "gauge");
+            for (const auto& [labels, gauge] : family.series) {
+                output.append(name).append(labels).append(" ").append(formatValue(gauge->get())).append("\n");
+            }
+        }
+
+        for (const auto& [name, family] : m_histograms) {
+            appendHeader(output, name, family.help, "histogram");
+            for (const auto& [labels, histogram] : family.series) {
+                // read the count first so the +Inf bucket is never smaller than a finite one
+                const auto count = histogram->getCount();
+
+                for (const auto bound : DEFAULT_LATENCY_BOUNDS) {
+                    const auto boundMicros = static_cast<uint64_t>(std::llround(bound * 1'000'000));
+                    const auto le = "le=\"" + formatValue(bound) + "\"";
+                    output.append(name).append("_bucket").append(appendLabel(labels, le)).append(" ")
+                          .append(std::to_string(std::min(count, histogram->getCountAtOrBelow(boundMicros)))).append("\n");
+                }
+                output.append(name).append("_bucket").append(appendLabel(labels, "le=\"+Inf\"")).append(" ")
+                      .append(std::to_string(count)).append("\n");
+                output.append(name).append("_sum").append(labels).append(" ")
+                      .append(formatValue(histogram->getSumMicros() / 1'000'000.0)).append("\n");
+                output.append(name).append("_count").append(labels).append(" ").append(std::to_string(count)).append("\n");
+            }
+        }
+
+        return output;
+    }
+
+    /**
+     * @brief Starts a background thread which periodically writes all metrics to a file.
+     *
+     * @param path The path of the file to write.
+     * @param interval The interval in which to write the file.
+     */
+    void MetricsRegistry::startTextfileWriter(const string& path, const milliseconds interval) {
+        stopTextfileWriter();
+
+        {
+            lock_guard<mutex> lock(m_writerMutex);
+            m_stopWriter = false;
+        }
+
+        m_writerThread = thread([this, path, interval]() {
+            unique_lock<mutex> lock(m_writerMutex);
+            do {
+                lock.unlock();
+                writeTextfile(path);
+                lock.lock();
+            } while (!m_writerCondition.wait_for(lock, interval, [this]() { return m_stopWriter; }));
+
+            lock.unlock();
+            writeTextfile(path); // final values on shutdown
+        });
+    }
+
+    /**
+     * @brief Stops the background writer and waits for it to finish.
+     */
+    void MetricsRegistry::stopTextfileWriter() {
+        {
+            lock_guard<mutex> lock(m_writerMutex);
+            m_stopWriter = true;
+        }
+        m_writerCondition.notify_all();
+
+        if (m_writerThread.joinable()) { m_writerThread.join(); }
+    }
+
+    /**
+     * @brief Gets or creates a series in a family.
+     *
+     * @tparam T The type of the metric.
+     * @param families The families of that type.
+     * @param name The name of the family.
+     * @param help The description of the family.
+     * @param labels The labels of the series.
+     *
+     * @return The series.
+     */
+    template<typename T>
+    shared_ptr<T> MetricsRegistry::getMetric(map<string, Family<T>>& families, const string& name, const string& help, const Labels& labels) {
+        const auto formattedLabels = formatLabels(labels);
+
+        {
+            shared_lock<shared_mutex> lock(m_mutex);
+            const auto family = families.find(name);
+            if (family != families.end()) {
+                const auto series = family->second.series.find(formattedLabels);
+                if (series != family->second.series.end()) { return series->second; }
+            }
+        }
+
+        unique_lock<shared_mutex> lock(m_mutex);
+        auto& family = families[name];
+        if (family.help.empty()) { family.help = help; }
+
+        auto& series = family.series[formattedLabels];
+        if (!series) { series = make_shared<T>(); }
+
+        return series;
+    }
+
+} /* namespace metrics */ } /* namespace abuseipdb_client */
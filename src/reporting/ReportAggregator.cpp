@@ -0,0 +1,168 @@
+/**
+ * @file ReportAggregator.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the ReportAggregator class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "reporting/ReportAggregator.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using std::chrono::duration_cast;
+    using std::lock_guard;
+    using std::vector;
+
+    const size_t ReportAggregator::MAX_COMMENT_LENGTH = 1024;
+    const string ReportAggregator::COMMENT_SEPARATOR = "; ";
+
+    /**
+     * @brief Appends a comment to a merged comment, truncating the result to MAX_COMMENT_LENGTH.
+     * 
+     * @param mergedComment The comment to append to.
+     * @param comments The comments already merged; the comment is added if it is appended.
+     * @param comment The comment to append. Ignored if it is empty or equal to a comment merged before.
+     */
+    static void appendComment(string& mergedComment, unordered_set<string>& comments, const string& comment) {
+        const static string ELLIPSIS = "...";
+
+        if (comment.empty() || mergedComment.size() >= ReportAggregator::MAX_COMMENT_LENGTH || !comments.insert(comment).second) { return; }
+
+        if (!mergedComment.empty()) { mergedComment += ReportAggregator::COMMENT_SEPARATOR; }
+        mergedComment += comment;
+
+        if (mergedComment.size() <= ReportAggregator::MAX_COMMENT_LENGTH) { return; }
+
+        // don't cut multi-byte characters in half
+        auto length = ReportAggregator::MAX_COMMENT_LENGTH - ELLIPSIS.size();
+        while (length > 0 && (static_cast<uint8_t>(mergedComment[length]) & 0xC0) == 0x80) { length--; }
+
+        mergedComment.resize(length);
+        mergedComment += ELLIPSIS;
+    }
+
+    /**
+     * @brief Adds a report to the aggregation window of its IP, opening a new window if none exists.
+     * If the window is zero, the report is emitted immediately (on the calling thread).
+     * 
+     * @param ipAddress The IP address to report.
+     * @param categories The categories of the report.
+     * @param comment The comment of the report.
+     * @param now The current time.
+     */
+    void ReportAggregator::add(const string& ipAddress, const AbuseIpDbApi::ReportCategories categories, const string& comment, const steady_clock::time_point now) {
+        if (m_window <= milliseconds(0)) {
+            // aggregation is disabled; emit the report as-is (still truncating the comment)
+            AbuseIpDbApi::BulkReportEntry report(ipAddress, categories, "", time(nullptr));
+            unordered_set<string> comments{};
+            appendComment(report.comment, comments, comment);
+
+            if (m_callback) { m_callback(report); }
+            return;
+        }
+
+        lock_guard<mutex> lock(m_mutex);
+
+        auto aggregate = m_aggregates.find(ipAddress);
+        if (aggregate == m_aggregates.end()) {
+            aggregate = m_aggregates.emplace(ipAddress, Aggregate{ AbuseIpDbApi::BulkReportEntry(ipAddress, categories, "", time(nullptr)), 1, {} }).first;
+            appendComment(aggregate->second.report.comment, aggregate->second.comments, comment);
+            m_deadlines.emplace_back(now + m_window, ipAddress);
+            return;
+        }
+
+        aggregate->second.report.categories = aggregate->second.report.categories | categories;
+        aggregate->second.mergedCount++;
+        appendComment(aggregate->second.report.comment, aggregate->second.comments, comment);
+    }
+
+    /**
+     * @brief Emits all merged reports whose aggregation window has elapsed.
+     * 
+     * @param now The current time.
+     * 
+     * @return size_t The amount of reports emitted.
+     */
+    size_t ReportAggregator::poll(const steady_clock::time_point now) { return emitUntil(now); }
+
+    /**
+     * @brief Emits all pending reports.
+     * 
+     * @return size_t The amount of reports emitted.
+     */
+    size_t ReportAggregator::flush() { return emitUntil(steady_clock::time_point::max()); }
+
+    /**
+     * @brief Gets the time until the next window elapses. Useful for determining how long to sleep.
+     * 
+     * @param now The current time.
+     * 
+     * @return milliseconds The time until the next report is due; milliseconds::max() if nothing is pending.
+     */
+    milliseconds ReportAggregator::getTimeUntilNextReport(const steady_clock::time_point now) const {
+        lock_guard<mutex> lock(m_mutex);
+
+        if (m_deadlines.empty()) { return milliseconds::max(); }
+
+        return std::max(duration_cast<milliseconds>(m_deadlines.front().first - now), milliseconds(0));
+    }
+
+    /**
+     * @brief Gets the amount of IPs with an open aggregation window.
+     */
+    size_t ReportAggregator::getPendingCount() const {
+        lock_guard<mutex> lock(m_mutex);
+
+        return m_aggregates.size();
+    }
+
+    /**
+     * @brief Emits all reports whose window elapses before the deadline.
+     * The callback is invoked without holding the lock, so it may add new reports.
+     * 
+     * @param deadline The deadline.
+     * 
+     * @return size_t The amount of reports emitted.
+     */
+    size_t ReportAggregator::emitUntil(const steady_clock::time_point deadline) {
+        vector<AbuseIpDbApi::BulkReportEntry> reports{};
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+
+            while (!m_deadlines.empty() && m_deadlines.front().first <= deadline) {
+                auto aggregate = m_aggregates.find(m_deadlines.front().second);
+                m_deadlines.pop_front();
+
+                if (aggregate == m_aggregates.end()) { continue; }
+
+                reports.push_back(std::move(aggregate->second.report));
+                m_aggregates.erase(aggregate);
+            }
+        }
+
+        if (m_callback) {
+            std::for_each(reports.begin(), reports.end(), m_callback);
+        }
+
+        return reports.size();
+    }
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
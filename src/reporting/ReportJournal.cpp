@@ -0,0 +1,571 @@
+/**
+ * @file ReportJournal.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the ReportJournal class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <system_error>
+
+// C
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "reporting/ReportJournal.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using std::error_code;
+    using std::lock_guard;
+    using std::shared_lock;
+    using std::unique_lock;
+
+    namespace fs = std::filesystem;
+
+    const size_t        ReportJournal::INITIAL_CAPACITY = 1024 * 1024;
+    const size_t        ReportJournal::COMPACTION_THRESHOLD = 1024 * 1024;
+    const milliseconds  ReportJournal::DEFAULT_SYNC_INTERVAL = milliseconds(10);
+
+    const static char       JOURNAL_MAGIC[8] = { 'A', 'I', 'P', 'D', 'B', 'W', 'A', 'L' };
+    const static uint32_t   JOURNAL_VERSION = 1;
+    const static uint32_t   RECORD_MARKER = 0x44524352; //!< Written last; a record without it was never completed
+    const static uint32_t   RECORD_PENDING = 0;
+    const static uint32_t   RECORD_ACKNOWLEDGED = 1;
+
+    /**
+     * @brief The header at the beginning of each journal file.
+     */
+    struct JournalHeader {
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    reserved;
+    };
+
+    /**
+     * @brief The header preceding each record in the journal.
+     */
+    struct JournalRecordHeader {
+        uint32_t    marker;     //!< RECORD_MARKER once the record is complete
+        uint32_t    length;     //!< The length of the payload
+        uint64_t    sequence;   //!< The sequence number of the record
+        uint32_t    checksum;   //!< FNV-1a over the sequence, length and payload
+        uint32_t    state;      //!< RECORD_PENDING or RECORD_ACKNOWLEDGED
+    };
+
+    /**
+     * @brief Gets the size of a record including its header, aligned to 8 bytes.
+     */
+    static size_t getRecordSize(const size_t payloadLength) {
+        return (sizeof(JournalRecordHeader) + payloadLength + 7) & ~size_t(7);
+    }
+
+    /**
+     * @brief Calculates the checksum of a record.
+     */
+    static uint32_t getRecordChecksum(const uint64_t sequence, const uint32_t length, const uint8_t* payload) {
+        uint32_t hash = 2166136261u;
+        const auto hashBytes = [&](const uint8_t* data, const size_t size) {
+            for (size_t i = 0; i < size; i++) { hash = (hash ^ data[i]) * 16777619u; }
+        };
+
+        hashBytes(reinterpret_cast<const uint8_t*>(&sequence), sizeof(sequence));
+        hashBytes(reinterpret_cast<const uint8_t*>(&length), sizeof(length));
+        hashBytes(payload, length);
+
+        return hash;
+    }
+
+    /**
+     * @brief Serialises a report to the payload of a record.
+     */
+    static string serialiseReport(const AbuseIpDbApi::BulkReportEntry& report) {
+        const uint64_t categories = static_cast<uint64_t>(report.categories);
+        const int64_t timestamp = report.timestamp;
+        const uint32_t ipLength = report.ipAddress.size();
+        const uint32_t commentLength = report.comment.size();
+
+        string payload(sizeof(categories) + sizeof(timestamp) + sizeof(ipLength) + sizeof(commentLength), '\0');
+        auto* pos = payload.data();
+        std::memcpy(pos, &categories, sizeof(categories));          pos += sizeof(categories);
+        std::memcpy(pos, &timestamp, sizeof(timestamp));            pos += sizeof(timestamp);
+        std::memcpy(pos, &ipLength, sizeof(ipLength));              pos += sizeof(ipLength);
+        std::memcpy(pos, &commentLength, sizeof(commentLength));
+
+        return payload + report.ipAddress + report.comment;
+    }
+
+    /**
+     * @brief Deserialises the payload of a record.
+     */
+    static AbuseIpDbApi::BulkReportEntry deserialiseReport(const uint8_t* payload) {
+        uint64_t categories = 0;
+        int64_t timestamp = 0;
+        uint32_t ipLength = 0;
+        uint32_t commentLength = 0;
+
+        std::memcpy(&categories, payload, sizeof(categories));          payload += sizeof(categories);
+        std::memcpy(&timestamp, payload, sizeof(timestamp));            payload += sizeof(timestamp);
+        std::memcpy(&ipLength, payload, sizeof(ipLength));              payload += sizeof(ipLength);
+        std::memcpy(&commentLength, payload, sizeof(commentLength));    payload += sizeof(commentLength);
+
+        const auto* chars = reinterpret_cast<const char*>(payload);
+
+        return AbuseIpDbApi::BulkReportEntry(
+            string(chars, ipLength), static_cast<AbuseIpDbApi::ReportCategories>(categories),
+            string(chars + ipLength, commentLength), static_cast<time_t>(timestamp)
+        );
+    }
+
+    /**
+     * @brief Throws a filesystem_error containing the current errno.
+     */
+    [[noreturn]] static void throwJournalError(const string& message, const string& path) {
+        throw fs::filesystem_error(message, fs::path(path), error_code(errno, std::system_category()));
+    }
+
+    /**
+     * @brief Opens (or creates) a journal and replays all records contained within.
+     * 
+     * @param path The path to the journal file.
+     * @param logger The logger.
+     * @param syncInterval The maximum time between a record being written and it being synced to disk.
+     */
+    ReportJournal::ReportJournal(const string& path, shared_ptr<logger> logger, const milliseconds syncInterval):
+        m_isDirty(false), m_isRunning(true), m_fd(-1), m_pending({}), m_syncInterval(syncInterval), m_logger(logger),
+        m_acknowledgedBytes(0), m_capacity(0), m_writeOffset(0), m_path(path), m_nextSequence(1), m_mapping(nullptr) {
+        openJournal(m_path);
+        replay();
+
+        m_logger->info("Opened report journal {:s} with {:d} pending reports", m_path, m_pending.size());
+
+        m_syncThread = thread(&ReportJournal::runSyncThread, this);
+    }
+
+    ReportJournal::~ReportJournal() {
+        m_isRunning = false;
+        m_syncCondition.notify_all();
+        if (m_syncThread.joinable()) { m_syncThread.join(); }
+
+        sync();
+        closeJournal();
+    }
+
+    /**
+     * @brief Appends a report to the journal.
+     * The report is durable once the sync thread has run, which happens within the sync interval.
+     * 
+     * @param report The report to append.
+     * 
+     * @return uint64_t The sequence number of the report; required for acknowledging it.
+     */
+    uint64_t ReportJournal::enqueue(const AbuseIpDbApi::BulkReportEntry& report) {
+        const auto payload = serialiseReport(report);
+        const auto recordSize = getRecordSize(payload.size());
+
+        while (true) {
+            {
+                shared_lock<shared_mutex> mapLock(m_mapMutex);
+                lock_guard<mutex> lock(m_mutex);
+
+                // always leave room for an empty header, which terminates the journal
+                if (m_writeOffset + recordSize + sizeof(JournalRecordHeader) <= m_capacity) {
+                    auto* record = m_mapping + m_writeOffset;
+                    auto* header = reinterpret_cast<JournalRecordHeader*>(record);
+                    const auto sequence = m_nextSequence++;
+
+                    std::memcpy(record + sizeof(JournalRecordHeader), payload.data(), payload.size());
+                    std::memset(record + recordSize, 0, sizeof(JournalRecordHeader));
+
+                    header->length = payload.size();
+                    header->sequence = sequence;
+                    header->checksum = getRecordChecksum(sequence, header->length, record + sizeof(JournalRecordHeader));
+                    header->state = RECORD_PENDING;
+                    header->marker = RECORD_MARKER;
+
+                    m_pending.emplace(sequence, m_writeOffset);
+                    m_writeOffset += recordSize;
+                    m_isDirty = true;
+
+                    return sequence;
+                }
+            }
+
+            grow(recordSize);
+        }
+    }
+
+    /**
+     * @brief Marks a report as sent. Acknowledged reports are removed when the journal is compacted.
+     * 
+     * @param sequence The sequence number returned by enqueue().
+     * 
+     * @return true If the report was pending.
+     */
+    bool ReportJournal::acknowledge(const uint64_t sequence) {
+        shared_lock<shared_mutex> mapLock(m_mapMutex);
+        lock_guard<mutex> lock(m_mutex);
+
+        const auto pending = m_pending.find(sequence);
+        if (pending == m_pending.end()) { return false; }
+
+        auto* header = reinterpret_cast<JournalRecordHeader*>(m_mapping + pending->second);
+        header->state = RECORD_ACKNOWLEDGED;
+
+        m_acknowledgedBytes += getRecordSize(header->length);
+        m_pending.erase(pending);
+        m_isDirty = true;
+
+        return true;
+    }
+
+    /**
+     * @brief Rewrites all pending records into a new file, which then atomically replaces the journal.
+     * 
+     * The pending records are copied and synced to the new file while reports may still be enqueued and acknowledged;
+     * the map is only locked exclusively to copy the records added since, apply the acknowledgements and swap the files.
+     */
+    void ReportJournal::compact() {
+        lock_guard<mutex> compactLock(m_compactMutex);
+
+        const auto tmpPath = m_path + ".tmp";
+
+        size_t usedSize = sizeof(JournalHeader) + sizeof(JournalRecordHeader);
+        {
+            shared_lock<shared_mutex> mapLock(m_mapMutex);
+            lock_guard<mutex> lock(m_mutex);
+
+            for (const auto& pending : m_pending) {
+                usedSize += getRecordSize(reinterpret_cast<JournalRecordHeader*>(m_mapping + pending.second)->length);
+            }
+        }
+
+        size_t capacity = INITIAL_CAPACITY;
+        while (capacity < usedSize) { capacity *= 2; }
+
+        const auto fd = open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) { throwJournalError("Failed to create compacted journal", tmpPath); }
+
+        auto* mapping = static_cast<uint8_t*>(MAP_FAILED);
+        const auto discardCompaction = [&](const string& message) {
+            const auto error = errno;
+            if (mapping != MAP_FAILED) { munmap(mapping, capacity); }
+            close(fd);
+            unlink(tmpPath.c_str());
+
+            errno = error;
+            throwJournalError(message, tmpPath);
+        };
+
+        if (ftruncate(fd, capacity) != 0) { discardCompaction("Failed to size compacted journal"); }
+
+        mapping = static_cast<uint8_t*>(mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+        if (mapping == MAP_FAILED) { discardCompaction("Failed to map compacted journal"); }
+
+        // copies the pending records with a sequence of at least firstSequence; must be called with the map locked
+        map<uint64_t, size_t> newPending{};
+        size_t writeOffset = sizeof(JournalHeader);
+        const auto copyPending = [&](const uint64_t firstSequence) {
+            for (auto pending = m_pending.lower_bound(firstSequence); pending != m_pending.end(); pending++) {
+                const auto recordSize = getRecordSize(reinterpret_cast<JournalRecordHeader*>(m_mapping + pending->second)->length);
+
+                if (writeOffset + recordSize + sizeof(JournalRecordHeader) > capacity) {
+                    auto newCapacity = capacity;
+                    while (writeOffset + recordSize + sizeof(JournalRecordHeader) > newCapacity) { newCapacity *= 2; }
+
+                    auto* newMapping = ftruncate(fd, newCapacity) == 0 ? mremap(mapping, capacity, newCapacity, MREMAP_MAYMOVE) : MAP_FAILED;
+                    if (newMapping == MAP_FAILED) { return false; }
+
+                    mapping = static_cast<uint8_t*>(newMapping);
+                    capacity = newCapacity;
+                }
+
+                std::memcpy(mapping + writeOffset, m_mapping + pending->second, recordSize);
+                newPending.emplace(pending->first, writeOffset);
+                writeOffset += recordSize;
+            }
+
+            return true;
+        };
+
+        // copy a snapshot of the pending records; enqueue() and acknowledge() only need the map shared
+        uint64_t snapshotSequence = 0;
+        {
+            shared_lock<shared_mutex> mapLock(m_mapMutex);
+            lock_guard<mutex> lock(m_mutex);
+
+            std::memcpy(mapping, m_mapping, sizeof(JournalHeader));
+            if (!copyPending(0)) { discardCompaction("Failed to grow compacted journal"); }
+            snapshotSequence = m_nextSequence;
+        }
+
+        if (msync(mapping, capacity, MS_SYNC) != 0 || fsync(fd) != 0) { discardCompaction("Failed to sync compacted journal"); }
+
+        const auto snapshotOffset = writeOffset;
+        uint8_t* oldMapping = nullptr;
+        size_t oldCapacity = 0;
+        int32_t oldFd = -1;
+        {
+            unique_lock<shared_mutex> mapLock(m_mapMutex);
+            lock_guard<mutex> lock(m_mutex);
+
+            // catch up with the records enqueued and acknowledged since the snapshot
+            if (!copyPending(snapshotSequence)) { discardCompaction("Failed to grow compacted journal"); }
+
+            size_t acknowledgedBytes = 0;
+            for (auto pending = newPending.begin(); pending != newPending.end();) {
+                if (m_pending.count(pending->first)) {
+                    pending++;
+                    continue;
+                }
+
+                auto* header = reinterpret_cast<JournalRecordHeader*>(mapping + pending->second);
+                header->state = RECORD_ACKNOWLEDGED;
+                acknowledgedBytes += getRecordSize(header->length);
+                pending = newPending.erase(pending);
+            }
+
+            // the records added since the snapshot may already be durable in the old journal; they must not be lost by the rename
+            const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            const auto syncStart = snapshotOffset / pageSize * pageSize;
+            if (writeOffset > snapshotOffset && msync(mapping + syncStart, writeOffset - syncStart, MS_SYNC) != 0) {
+                discardCompaction("Failed to sync compacted journal");
+            }
+
+            if (rename(tmpPath.c_str(), m_path.c_str()) != 0) { discardCompaction("Failed to replace journal"); }
+
+            SPDLOG_LOGGER_DEBUG(m_logger, "Compacted report journal; {:d} -> {:d} bytes", m_writeOffset, writeOffset);
+
+            oldMapping = m_mapping;
+            oldCapacity = m_capacity;
+            oldFd = m_fd;
+
+            m_fd = fd;
+            m_mapping = mapping;
+            m_capacity = capacity;
+            m_writeOffset = writeOffset;
+            m_acknowledgedBytes = acknowledgedBytes;
+            m_pending = std::move(newPending);
+            m_isDirty = m_isDirty || acknowledgedBytes > 0;
+        }
+
+        munmap(oldMapping, oldCapacity);
+        close(oldFd);
+
+        // make the rename itself durable; syncMapping() waits for this, so nothing is reported as synced before
+        const auto dirFd = open(fs::path(m_path).parent_path().empty() ? "." : fs::path(m_path).parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            fsync(dirFd);
+            close(dirFd);
+        }
+    }
+
+    /**
+     * @brief Synchronously syncs all changes to disk.
+     */
+    void ReportJournal::sync() {
+        m_isDirty = true;
+        syncMapping();
+    }
+
+    /**
+     * @brief Gets all reports which haven't been acknowledged yet, ordered by their sequence number.
+     * Call this after opening the journal to replay reports which weren't sent before the application exited.
+     */
+    vector<pair<uint64_t, AbuseIpDbApi::BulkReportEntry>> ReportJournal::getPending() const {
+        shared_lock<shared_mutex> mapLock(m_mapMutex);
+        lock_guard<mutex> lock(m_mutex);
+
+        vector<pair<uint64_t, AbuseIpDbApi::BulkReportEntry>> reports{};
+        reports.reserve(m_pending.size());
+
+        for (const auto& pending : m_pending) {
+            reports.emplace_back(pending.first, deserialiseReport(m_mapping + pending.second + sizeof(JournalRecordHeader)));
+        }
+
+        return reports;
+    }
+
+    /**
+     * @brief Gets the amount of reports which haven't been acknowledged yet.
+     */
+    size_t ReportJournal::getPendingCount() const {
+        lock_guard<mutex> lock(m_mutex);
+
+        return m_pending.size();
+    }
+
+    /**
+     * @brief Opens and maps the journal file, creating it if it doesn't exist.
+     * 
+     * @param path The path to the journal.
+     */
+    void ReportJournal::openJournal(const string& path) {
+        m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (m_fd < 0) { throwJournalError("Failed to open journal", path); }
+
+        struct stat fileStat{};
+        if (fstat(m_fd, &fileStat) != 0) { throwJournalError("Failed to stat journal", path); }
+
+        m_capacity = std::max<size_t>(fileStat.st_size, INITIAL_CAPACITY);
+        if (static_cast<size_t>(fileStat.st_size) < m_capacity && ftruncate(m_fd, m_capacity) != 0) {
+            throwJournalError("Failed to size journal", path);
+        }
+
+        m_mapping = static_cast<uint8_t*>(mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0));
+        if (m_mapping == MAP_FAILED) {
+            m_mapping = nullptr;
+            throwJournalError("Failed to map journal", path);
+        }
+
+        auto* header = reinterpret_cast<JournalHeader*>(m_mapping);
+        const JournalHeader emptyHeader{};
+
+        if (std::memcmp(header, &emptyHeader, sizeof(JournalHeader)) == 0) {
+            std::memcpy(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+            header->version = JOURNAL_VERSION;
+            m_isDirty = true;
+        } else if (std::memcmp(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header->version != JOURNAL_VERSION) {
+            errno = EINVAL;
+            throwJournalError("Not a report journal", path);
+        }
+    }
+
+    /**
+     * @brief Unmaps and closes the journal.
+     */
+    void ReportJournal::closeJournal() {
+        if (m_mapping) { munmap(m_mapping, m_capacity); }
+        if (m_fd >= 0) { close(m_fd); }
+
+        m_mapping = nullptr;
+        m_fd = -1;
+    }
+
+    /**
+     * @brief Scans the journal and rebuilds the index of pending records.
+     * Scanning stops at the first incomplete or corrupt record; anything after it was never synced.
+     */
+    void ReportJournal::replay() {
+        size_t offset = sizeof(JournalHeader);
+
+        while (offset + sizeof(JournalRecordHeader) <= m_capacity) {
+            const auto* header = reinterpret_cast<const JournalRecordHeader*>(m_mapping + offset);
+            const auto recordSize = getRecordSize(header->length);
+
+            if (header->marker != RECORD_MARKER || offset + recordSize + sizeof(JournalRecordHeader) > m_capacity ||
+                header->checksum != getRecordChecksum(header->sequence, header->length, m_mapping + offset + sizeof(JournalRecordHeader))) {
+                break;
+            }
+
+            if (header->state == RECORD_PENDING) {
+                m_pending.emplace(header->sequence, offset);
+            } else {
+                m_acknowledgedBytes += recordSize;
+            }
+
+            m_nextSequence = std::max(m_nextSequence, header->sequence + 1);
+            offset += recordSize;
+        }
+
+        // discard the remains of an incomplete record
+        if (offset + sizeof(JournalRecordHeader) <= m_capacity) {
+            std::memset(m_mapping + offset, 0, sizeof(JournalRecordHeader));
+        }
+
+        m_writeOffset = offset;
+    }
+
+    /**
+     * @brief Grows the journal so a record of the given size fits.
+     * 
+     * @param recordSize The size of the record which must fit.
+     */
+    void ReportJournal::grow(const size_t recordSize) {
+        unique_lock<shared_mutex> mapLock(m_mapMutex);
+        lock_guard<mutex> lock(m_mutex);
+
+        auto capacity = m_capacity;
+        while (m_writeOffset + recordSize + sizeof(JournalRecordHeader) > capacity) { capacity *= 2; }
+
+        if (capacity == m_capacity) { return; } // another thread beat us to it
+
+        if (ftruncate(m_fd, capacity) != 0) { throwJournalError("Failed to grow journal", m_path); }
+
+        auto* mapping = static_cast<uint8_t*>(mremap(m_mapping, m_capacity, capacity, MREMAP_MAYMOVE));
+        if (mapping == MAP_FAILED) { throwJournalError("Failed to remap journal", m_path); }
+
+        m_mapping = mapping;
+        m_capacity = capacity;
+    }
+
+    /**
+     * @brief The sync thread. Syncs all changes made within the last interval in one go and compacts the journal when required.
+     */
+    void ReportJournal::runSyncThread() {
+        while (m_isRunning) {
+            {
+                unique_lock<mutex> lock(m_syncMutex);
+                m_syncCondition.wait_for(lock, m_syncInterval, [&]() { return !m_isRunning; });
+            }
+
+            syncMapping();
+
+            if (!needsCompaction()) { continue; }
+
+            try {
+                compact();
+            } catch (const fs::filesystem_error& ex) {
+                m_logger->error("Failed to compact report journal: {:s}", ex.what());
+            }
+        }
+    }
+
+    /**
+     * @brief Syncs the used part of the mapping to disk, if anything changed since the last sync.
+     */
+    void ReportJournal::syncMapping() {
+        if (!m_isDirty.exchange(false)) { return; }
+
+        lock_guard<mutex> compactLock(m_compactMutex);
+        shared_lock<shared_mutex> mapLock(m_mapMutex);
+
+        size_t syncSize = 0;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            syncSize = std::min(m_capacity, m_writeOffset + sizeof(JournalRecordHeader));
+        }
+
+        if (msync(m_mapping, syncSize, MS_SYNC) != 0) {
+            m_logger->error("Failed to sync report journal: {:s}", std::strerror(errno));
+            m_isDirty = true;
+        }
+    }
+
+    /**
+     * @brief Determines whether enough records were acknowledged to warrant compacting the journal.
+     */
+    bool ReportJournal::needsCompaction() const {
+        lock_guard<mutex> lock(m_mutex);
+
+        return m_acknowledgedBytes >= COMPACTION_THRESHOLD && m_acknowledgedBytes * 2 >= m_writeOffset;
+    }
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
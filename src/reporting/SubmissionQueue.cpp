@@ -0,0 +1,182 @@
+/**
+ * @file SubmissionQueue.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the SubmissionQueue class.
+ * @version 0.1
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "reporting/SubmissionQueue.hpp"
+#include "trace/TraceRecorder.hpp"
+
+namespace abuseipdb_client { namespace reporting {
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::exception;
+
+    const size_t SubmissionQueue::DEFAULT_CAPACITY = 4096;
+
+    /**
+     * @brief Constructs a new SubmissionQueue. The consumer must be started with start().
+     * 
+     * @param api The API client. Must not be used by any other thread while the consumer is running.
+     * @param logger The logger.
+     * @param capacity The capacity of the queue. Rounded up to the next power of two.
+     */
+    SubmissionQueue::SubmissionQueue(shared_ptr<AbuseIpDbApi> api, shared_ptr<logger> logger, const size_t capacity):
+        m_signal(0), m_droppedCount(0), m_processedCount(0), m_submittedCount(0), m_isRunning(false),
+        m_api(api), m_logger(logger), m_queue(capacity) {}
+
+    /**
+     * @brief Queues a submission if there is room. Never blocks.
+     * 
+     * @param submission The submission.
+     * 
+     * @return true If the submission was queued.
+     * @return false If the queue is full; the submission was dropped.
+     */
+    bool SubmissionQueue::tryPush(Submission&& submission) {
+        if (!m_queue.tryPush(std::move(submission))) {
+            m_droppedCount++;
+            return false;
+        }
+
+        m_submittedCount++;
+        notifyConsumer();
+
+        return true;
+    }
+
+    /**
+     * @brief Queues a submission, backing off until there is room or the timeout elapses.
+     * 
+     * @param submission The submission.
+     * @param timeout The maximum time to wait.
+     * 
+     * @return true If the submission was queued.
+     * @return false If the timeout elapsed; the submission was dropped.
+     */
+    bool SubmissionQueue::push(Submission&& submission, const milliseconds timeout) {
+        const auto deadline = steady_clock::now() + timeout;
+        microseconds backoff(1);
+
+        while (!m_queue.tryPush(std::move(submission))) {
+            const auto now = steady_clock::now();
+            if (now >= deadline) {
+                m_droppedCount++;
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::min(backoff, duration_cast<microseconds>(deadline - now)));
+            backoff = std::min(backoff * 2, microseconds(1000));
+        }
+
+        m_submittedCount++;
+        notifyConsumer();
+
+        return true;
+    }
+
+    /**
+     * @brief Starts the consumer thread.
+     */
+    void SubmissionQueue::start() {
+        if (m_isRunning.exchange(true)) { return; }
+
+        m_consumer = thread(&SubmissionQueue::runConsumer, this);
+    }
+
+    /**
+     * @brief Stops the consumer thread. Any submissions still in the queue are processed first.
+     */
+    void SubmissionQueue::stop() {
+        if (!m_isRunning.exchange(false)) { return; }
+
+        notifyConsumer();
+        if (m_consumer.joinable()) { m_consumer.join(); }
+    }
+
+    /**
+     * @brief Wakes the consumer thread, if it is waiting.
+     */
+    void SubmissionQueue::notifyConsumer() {
+        m_signal.fetch_add(1, std::memory_order_release);
+        m_signal.notify_one();
+    }
+
+    /**
+     * @brief Performs the request of a single submission and invokes its callback.
+     * 
+     * Exceptions thrown by the request or the callback are logged, so they cannot stop the consumer thread.
+     * 
+     * @param submission The submission.
+     */
+    void SubmissionQueue::process(Submission& submission) {
+        ABUSEIPDB_TRACE_ASYNC("queued", "queue", submission.submittedAt);
+        ABUSEIPDB_TRACE_SPAN("SubmissionQueue::process", "queue");
+        json response{};
+
+        try {
+            switch (submission.type) {
+                case Submission::Type::Report:
+                    response = m_api->reportIp(submission.report.ipAddress, submission.report.categories, submission.report.comment);
+                    break;
+                case Submission::Type::Check:
+                    response = m_api->checkIpAddress(submission.report.ipAddress);
+                    break;
+            }
+        } catch (const exception& ex) {
+            m_logger->error("Failed to process submission for {:s}: {:s}", submission.report.ipAddress, ex.what());
+        }
+
+        m_processedCount++;
+
+        if (!submission.callback) { return; }
+
+        // an exception escaping the consumer thread would terminate the process
+        try {
+            ABUSEIPDB_TRACE_SPAN("Submission::callback", "queue");
+            submission.callback(response);
+        } catch (const exception& ex) {
+            m_logger->error("Callback for submission of {:s} failed: {:s}", submission.report.ipAddress, ex.what());
+        } catch (...) {
+            m_logger->error("Callback for submission of {:s} failed with an unknown exception!", submission.report.ipAddress);
+        }
+    }
+
+    /**
+     * @brief The consumer thread. Drains the queue and sleeps until notified when it is empty.
+     */
+    void SubmissionQueue::runConsumer() {
+        Submission submission{};
+
+        while (true) {
+            const auto signal = m_signal.load(std::memory_order_acquire);
+
+            while (m_queue.tryPop(submission)) { process(submission); }
+
+            if (!m_isRunning) { break; }
+
+            m_signal.wait(signal, std::memory_order_acquire);
+        }
+
+        // drain anything pushed while stopping
+        while (m_queue.tryPop(submission)) { process(submission); }
+    }
+
+} /* namespace reporting */ } /* namespace abuseipdb_client */
@@ -0,0 +1,297 @@
+/**
+ * @file TraceRecorder.cpp
+ * @author Simon Cahill (simon@simonc.eu)
+ * @brief Contains the implementation of the TraceRecorder class.
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2022 Simon Cahill
+ */
+
+///////////////////////
+//  SYSTEM INCLUDES  //
+///////////////////////
+// stl
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// C
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+///////////////////////
+//  LOCAL  INCLUDES  //
+///////////////////////
+#include "trace/TraceRecorder.hpp"
+
+namespace abuseipdb_client { namespace trace {
+
+    using std::lock_guard;
+    using std::make_shared;
+    using std::memory_order_acquire;
+    using std::memory_order_relaxed;
+    using std::memory_order_release;
+    using std::unique_lock;
+
+    const size_t TraceRecorder::BUFFER_CAPACITY = 8192;
+
+    /**
+     * @brief Writes a string to a file descriptor, retrying on partial writes.
+     *
+     * @param fd The file descriptor.
+     * @param data The data to write.
+     *
+     * @return true If everything was written.
+     */
+    static bool writeAll(const int32_t fd, const string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            const auto result = write(fd, data.data() + written, data.size() - written);
+            if (result < 0 && errno == EINTR) { continue; }
+            if (result <= 0) { return false; }
+
+            written += static_cast<size_t>(result);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Appends a timestamp in the microseconds expected by the trace format, keeping nanosecond precision.
+     *
+     * @param output The string to append to.
+     * @param nanoseconds The timestamp in nanoseconds.
+     */
+    static void appendMicros(string& output, const uint64_t nanoseconds) {
+        char buffer[32]{};
+        const auto length = snprintf(buffer, sizeof(buffer), "%" PRIu64 ".%03" PRIu64, nanoseconds / 1000, nanoseconds % 1000);
+
+        output.append(buffer, std::max(length, 0));
+    }
+
+    /**
+     * @brief Constructs an empty buffer for the calling thread.
+     */
+    TraceRecorder::ThreadBuffer::ThreadBuffer():
+        events(BUFFER_CAPACITY), head(0), cachedTail(0), tail(0), threadId(gettid()), threadName(), isNameWritten(false) {
+        char name[16]{};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        threadName = name;
+    }
+
+    /**
+     * @brief Constructs the (stopped) recorder.
+     */
+    TraceRecorder::TraceRecorder():
+        m_isEnabled(false), m_droppedCount(0), m_nextAsyncId(1), m_stopFlusher(false),
+        m_fd(-1), m_processId(getpid()) {}
+
+    /**
+     * @brief Records a span in the buffer of the calling thread.
+     *
+     * @param event The span to record.
+     */
+    void TraceRecorder::record(const TraceEvent& event) {
+        if (!isEnabled()) { return; }
+
+        auto& buffer = getThreadBuffer();
+        const auto head = buffer.head.load(memory_order_relaxed);
+
+        if (head - buffer.cachedTail >= BUFFER_CAPACITY) {
+            buffer.cachedTail = buffer.tail.load(memory_order_acquire);
+
+            if (head - buffer.cachedTail >= BUFFER_CAPACITY) {
+                m_droppedCount.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+        }
+
+        buffer.events[head % BUFFER_CAPACITY] = event;
+        buffer.head.store(head + 1, memory_order_release);
+    }
+
+    /**
+     * @brief Records a span which ends now.
+     *
+     * Async spans may overlap the spans of the recording thread, e.g. the time a submission waited in a queue.
+     *
+     * @param name The name of the span. Must be a string literal.
+     * @param category The category of the span. Must be a string literal.
+     * @param start The start of the span.
+     */
+    void TraceRecorder::recordAsync(const char* name, const char* category, const steady_clock::time_point start) {
+        if (!isEnabled()) { return; }
+
+        const auto startTimestamp = getTimestamp(start);
+        const auto endTimestamp = getTimestamp();
+
+        record({ name, category, startTimestamp, endTimestamp > startTimestamp ? endTimestamp - startTimestamp : 0,
+                 m_nextAsyncId.fetch_add(1, memory_order_relaxed) });
+    }
+
+    /**
+     * @brief Starts recording spans to a file.
+     *
+     * Any previous recording is stopped first.
+     *
+     * @param path The path of the trace file. Existing files are overwritten.
+     * @param flushInterval The interval in which the buffers are written to the file.
+     *
+     * @return true If the file could be opened and recording started.
+     */
+    bool TraceRecorder::start(const string& path, const milliseconds flushInterval) {
+        stop();
+
+        const auto fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) { return false; }
+
+        if (!writeAll(fd, "[\n")) {
+            close(fd);
+            return false;
+        }
+
+        {
+            lock_guard<mutex> lock(m_flushMutex);
+            m_fd = fd;
+            m_stopFlusher = false;
+        }
+
+        {
+            lock_guard<mutex> lock(m_bufferMutex);
+            for (auto& buffer : m_buffers) {
+                buffer->tail.store(buffer->head.load(memory_order_acquire), memory_order_release); // discard spans of a previous recording
+                buffer->isNameWritten = false;
+            }
+        }
+
+        m_isEnabled = true;
+        m_flusher = thread(&TraceRecorder::runFlusher, this, flushInterval);
+
+        return true;
+    }
+
+    /**
+     * @brief Stops recording, writes all buffered spans and closes the trace file.
+     */
+    void TraceRecorder::stop() {
+        m_isEnabled = false;
+
+        {
+            lock_guard<mutex> lock(m_flushMutex);
+            m_stopFlusher = true;
+        }
+        m_flushCondition.notify_all();
+
+        if (m_flusher.joinable()) { m_flusher.join(); }
+
+        lock_guard<mutex> lock(m_flushMutex);
+        if (m_fd < 0) { return; }
+
+        // close the array with an entry that needs no trailing comma, so the file is valid JSON
+        writeAll(m_fd, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + std::to_string(m_processId) + ",\"args\":{\"name\":\"abuseipdb-client\"}}\n]\n");
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    /**
+     * @brief Gets the buffer of the calling thread, creating and registering it on first use.
+     *
+     * The buffer is shared with the recorder, so spans of threads which exited are still written.
+     */
+    TraceRecorder::ThreadBuffer& TraceRecorder::getThreadBuffer() {
+        thread_local shared_ptr<ThreadBuffer> buffer = nullptr;
+
+        if (!buffer) {
+            buffer = make_shared<ThreadBuffer>();
+
+            lock_guard<mutex> lock(m_bufferMutex);
+            m_buffers.push_back(buffer);
+        }
+
+        return *buffer;
+    }
+
+    /**
+     * @brief Writes all buffered spans to the trace file.
+     *
+     * Must be called with m_flushMutex held.
+     */
+    void TraceRecorder::flush() {
+        if (m_fd < 0) { return; }
+
+        vector<shared_ptr<ThreadBuffer>> buffers{};
+        {
+            lock_guard<mutex> lock(m_bufferMutex);
+            buffers = m_buffers;
+        }
+
+        string output{};
+        const auto pid = std::to_string(m_processId);
+
+        for (auto& buffer : buffers) {
+            const auto tid = std::to_string(buffer->threadId);
+            const auto tail = buffer->tail.load(memory_order_relaxed);
+            const auto head = buffer->head.load(memory_order_acquire);
+
+            if (!buffer->isNameWritten) {
+                output.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid).append(",\"tid\":").append(tid)
+                      .append(",\"args\":{\"name\":\"").append(buffer->threadName).append("\"}},\n");
+                buffer->isNameWritten = true;
+            }
+
+            for (auto i = tail; i < head; i++) {
+                const auto& event = buffer->events[i % BUFFER_CAPACITY];
+                const auto prefix = string("{\"name\":\"") + event.name + "\",\"cat\":\"" + event.category + "\",\"pid\":" + pid + ",\"tid\":" + tid;
+
+                if (event.asyncId == 0) {
+                    output.append(prefix).append(",\"ph\":\"X\",\"ts\":");
+                    appendMicros(output, event.start);
+                    output.append(",\"dur\":");
+                    appendMicros(output, event.duration);
+                    output.append("},\n");
+                } else {
+                    const auto id = std::to_string(event.asyncId);
+                    output.append(prefix).append(",\"ph\":\"b\",\"id\":").append(id).append(",\"ts\":");
+                    appendMicros(output, event.start);
+                    output.append("},\n");
+                    output.append(prefix).append(",\"ph\":\"e\",\"id\":").append(id).append(",\"ts\":");
+                    appendMicros(output, event.start + event.duration);
+                    output.append("},\n");
+                }
+            }
+
+            buffer->tail.store(head, memory_order_release);
+        }
+
+        writeAll(m_fd, output);
+        buffers.clear();
+
+        // drop the buffers of threads which exited once they're drained
+        lock_guard<mutex> lock(m_bufferMutex);
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](const auto& buffer) {
+            return buffer.use_count() == 1 && buffer->head.load(memory_order_acquire) == buffer->tail.load(memory_order_relaxed);
+        }), m_buffers.end());
+    }
+
+    /**
+     * @brief The flusher thread. Periodically writes all buffers, and once more when stopped.
+     *
+     * @param flushInterval The interval in which to write the buffers.
+     */
+    void TraceRecorder::runFlusher(const milliseconds flushInterval) {
+        unique_lock<mutex> lock(m_flushMutex);
+
+        while (!m_flushCondition.wait_for(lock, flushInterval, [this]() { return m_stopFlusher; })) {
+            flush();
+        }
+
+        flush();
+    }
+
+} /* namespace trace */ } /* namespace abuseipdb_client */